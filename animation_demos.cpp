@@ -1,5 +1,35 @@
 #include "animation_demos.h" // Demo class
 #include "tgraphics.h" // Timers/Pixel
+#include "gradient_lut.h"
+#include "polar_raster.h"
+
+// Default no-op implementations, so the Demo vtable/typeinfo always link
+void Demo::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
+  r = radius;
+  d = diameter;
+  pixels = pix;
+}
+
+void Demo::tick() {
+}
+
+void Demo::processKeypress(uint16_t keys, uint16_t diff) {
+}
+
+void Demo::setBuffer(Pixel* pix) {
+  pixels = pix;
+}
+
+void Demo::update(ColumnScheduler& sched) {
+  tick(); // demos that don't render by column draw the whole frame themselves
+}
+
+void Demo::renderColumns(uint32_t firstCol, uint32_t numCols) {
+}
+
+uint32_t Demo::rotation() const {
+  return 0;
+}
 
 //##################
 // Simple Flash Demo 
@@ -13,7 +43,7 @@ SimpleFlash::SimpleFlash(Pixel flash, uint32_t delayUs, float bright) {
   palette = (Pixel*)&colorsExceptBlack;
   paletteLength = 12;
   delayInUs = delayUs;
-  brightness = bright;
+  brightness = toScale16(bright);
 }
 
 void SimpleFlash::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
@@ -29,21 +59,37 @@ void SimpleFlash::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
   timer.start(micros(),delayInUs);
 }
 
-void SimpleFlash::tick() {
+// returns true when the color flipped
+bool SimpleFlash::advance() {
   if (!timer.check()) { // timer still going
-    return;
+    return false;
   } else {
     flip = !flip;
     timer.reset();
   }
-  for (uint32_t i = 0; i < d; i++) {
-    for (uint32_t j = 0; j < r; j++) {
-     pixels[indexAt(r,i,j)] = flip ? flashColor * brightness : prevColor * brightness;
-    }
-  }
+  return true;
+}
+
+void SimpleFlash::tick() {
+  TGRAPHICS_PROBE("SimpleFlash::tick");
+  if (advance())
+    renderColumns(0, d);
+}
+
+void SimpleFlash::update(ColumnScheduler& sched) {
+  if (advance())
+    sched.markAllDirty();
+}
+
+void SimpleFlash::renderColumns(uint32_t firstCol, uint32_t numCols) {
+  TGRAPHICS_PROBE("SimpleFlash::renderColumns");
+  // columns are contiguous, scale the color once and fill the whole range
+  Pixel color = flip ? flashColor * brightness : prevColor * brightness;
+  vecFill(color, pixels + indexAt(r, firstCol, 0), r * numCols);
 }
 
 void SimpleFlash::processKeypress(uint16_t keys, uint16_t diff) {
+  TGRAPHICS_PROBE("SimpleFlash::processKeypress");
   for (int i = 0; i < 12; i++) {
     if ((diff & 1) && (keys & 1)) {
       prevColor = flashColor;
@@ -60,9 +106,13 @@ void SimpleFlash::processKeypress(uint16_t keys, uint16_t diff) {
 // Rainbow wheel Demo, display a circular rainbow that rotates
 //############################################################
 
-RainbowWheel::RainbowWheel(float bright) {
+RainbowWheel::RainbowWheel(float bright, uint32_t fTime) {
   rainbowOffset = 0;
-  brightness = bright;
+  drawnShift = 0;
+  remainder = 0;
+  brightness = toScale16(bright);
+  frameTime = fTime;
+  rotationAware = false;
 }
 
 void RainbowWheel::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
@@ -70,35 +120,80 @@ void RainbowWheel::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
   r = radius;
   d = diameter;
   pixels = pix;
-  for (uint32_t i = 0; i < d; i++) { // col #
-    float percent = (float)((i+rainbowOffset) % d) / d; // fraction of the sweep
-    Pixel col = rainbowAt(percent,rainbow12,12) * brightness;
-    for (uint32_t j = 0; j < r; j++) { // ring # 
-      pixels[indexAt(r,i,j)] = col;
-    }
-  }
-  //timer.start(micros(),frameTime); // 10ms
+  rainbowOffset = 0;
+  drawnShift = 0;
+  remainder = 0;
+  renderColumns(0, d);
+  lastUs = micros();
+}
+
+void RainbowWheel::setRotationAware(bool aware) {
+  rotationAware = aware;
+}
+
+// Rotating is just moving the offset, the pixels only change when the
+// reader can't apply rotation() and the offset crossed a whole column
+void RainbowWheel::advance() {
+  if (frameTime == 0)
+    return;
+  uint32_t now = micros();
+  uint64_t elapsed = ((uint64_t)(now - lastUs) << 16) + remainder; // us << 16
+  lastUs = now;
+  remainder = elapsed % frameTime;
+  rainbowOffset = (rainbowOffset + elapsed / frameTime) % ((uint64_t)d << 16);
 }
+
+uint32_t RainbowWheel::wantedShift() const {
+  return rotationAware ? 0 : rainbowOffset >> 16;
+}
+
 void RainbowWheel::tick() {
-    return; // do nothing
-    /*
-    for (uint32_t i = colOffset; i != (d + colOffset) % d; i = (i + 1) % d) { // across ring
-        float percent = (float)((i+rainbowOffset) % d) / d; // fraction of the sweep
-        Pixel col = rainbowAt(percent,rainbow12,12);
-        for (uint32_t j = 0; j < r; j++) { // across radius
-            pixels[indexAt(r,i,j)] =  col;
-        }
-    }
-    */
+  TGRAPHICS_PROBE("RainbowWheel::tick");
+  advance();
+  if (wantedShift() != drawnShift) {
+    drawnShift = wantedShift();
+    renderColumns(0, d);
+  }
+}
+
+void RainbowWheel::update(ColumnScheduler& sched) {
+  advance();
+  if (wantedShift() != drawnShift) { // every column moved
+    drawnShift = wantedShift();
+    sched.markAllDirty();
+  }
+}
+
+uint32_t RainbowWheel::rotation() const {
+  return rotationAware ? rainbowOffset : 0;
+}
+
+void RainbowWheel::renderColumns(uint32_t firstCol, uint32_t numCols) {
+  TGRAPHICS_PROBE("RainbowWheel::renderColumns");
+  for (uint32_t i = firstCol; i < firstCol + numCols; i++) { // col #
+    // same as a RotatedView: buffer column i shows wheel column i + drawnShift
+    uint32_t wheelCol = i + drawnShift < d ? i + drawnShift : i + drawnShift - d;
+    uint16_t phase = phaseOf(wheelCol, d); // fraction of the sweep
+    Pixel col = rainbow12LUT.at(phase) * brightness;
+    vecFill(col, pixels + indexAt(r,i,0), r); // along the radius same color
+  }
 }
 
 void RainbowWheel::processKeypress(uint16_t keys, uint16_t diff) {
     
 }
 
-RingDemo::RingDemo(float bright, uint32_t fTime) {
-  brightness = bright;
+//###############################################
+// Ring Demo, a ring that moves in and out
+//###############################################
+
+static const int32_t ringWidth = 0x18000; // 1.5 rings
+
+RingDemo::RingDemo(float bright, uint32_t fTime) : wave(0.5f) {
+  brightness = toScale16(bright);
   frameTime = fTime;
+  color = Colors::Cyan;
+  center = 0;
 }
 
 void RingDemo::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
@@ -106,16 +201,147 @@ void RingDemo::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
   r = radius;
   d = diameter;
   pixels = pix;
-  for (uint32_t i = 0; i < d; i++) { // col #
-      for (uint32_t j = 0; j < r; j++) { // ring # 
-          pixels[indexAt(r,i,j)] = Colors::Black;
-      }
-  }
+  vecFill(Colors::Black, pixels, r * d);
+  clock.tick(micros());
   timer.start(micros(),frameTime); // 10ms
 }
+
 void RingDemo::tick() {
+  TGRAPHICS_PROBE("RingDemo::tick");
+  if (!timer.check())
+    return;
+  timer.reset();
+  clock.tick(micros());
+  wave.advance(clock);
+
+  PolarRaster raster(pixels, r, d);
+  // erase last frame's ring (whole pixels, so no anti-aliased fringe is left behind)
+  raster.ring(center - ringWidth / 2 - 0x10000, center + ringWidth / 2 + 0x10000, Colors::Black);
+  int32_t travel = (int32_t)(r << 16) - ringWidth;
+  center = ringWidth / 2 + (int32_t)(((int64_t)travel * wave.sine()) >> 16);
+  raster.setAntialias(true);
+  raster.ring(center - ringWidth / 2, center + ringWidth / 2, color * brightness);
 }
 
 void RingDemo::processKeypress(uint16_t keys, uint16_t diff) {
-    
+  TGRAPHICS_PROBE("RingDemo::processKeypress");
+  for (uint32_t i = 0; i < 12; i++) {
+    if ((diff & 1) && (keys & 1)) {
+      color = colorsExceptBlack[i];
+      break;
+    }
+    diff >>= 1;
+    keys >>= 1;
+  }
+}
+
+//##########################################################
+// Fireworks Demo, each key shoots a burst of fading sparks
+//##########################################################
+
+Fireworks::Fireworks(float bright, uint32_t life) : sparks(1, 1) {
+  brightness = toScale16(bright);
+  lifeMs = life;
+}
+
+void Fireworks::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
+  r = radius;
+  d = diameter;
+  pixels = pix;
+  vecFill(Colors::Black, pixels, r * d);
+  sparks.setBounds(r, d);
+  sparks.setGravity(toFixed16(r * 0.5f)); // sparks drift outwards
+  sparks.clear();
+  lastUs = micros();
+  fadeCarry = 0;
+}
+
+void Fireworks::tick() {
+  TGRAPHICS_PROBE("Fireworks::tick");
+  uint32_t now = micros();
+  uint32_t dt = now - lastUs;
+  lastUs = now;
+  sparks.update(dt);
+  sparks.splat(pixels);
+  // trails: fade the brightest spark out over ~250ms. Sparks are 8-bit colors times
+  // brightness, so that's the scale, and the remainder carries over so short ticks fade too
+  uint32_t peak = qmult16(0xff, brightness);
+  uint64_t fadeUs = (uint64_t)dt * peak + fadeCarry;
+  uint64_t fade = fadeUs / TrailUs;
+  fadeCarry = (uint32_t)(fadeUs % TrailUs);
+  // A spark sitting on a pixel splats it every tick, so clamp to peak first or trails
+  // would start far brighter: + (0xffff - peak) saturates everything above peak, and
+  // subtracting it back (plus the fade) leaves min(v, peak) - fade
+  uint32_t headroom = 0xffff - peak;
+  uint64_t down = headroom + fade;
+  vecBrighten(pixels, pixels, headroom, r * d);
+  vecFade(pixels, pixels, down > 0xffff ? 0xffff : (uint16_t)down, r * d);
+}
+
+void Fireworks::processKeypress(uint16_t keys, uint16_t diff) {
+  TGRAPHICS_PROBE("Fireworks::processKeypress");
+  for (uint32_t i = 0; i < 12; i++) {
+    if ((diff & 1) && (keys & 1)) { // pressed, not released
+      Pixel color = colorsExceptBlack[i] * brightness;
+      int32_t col = toFixed16((float)(i * d) / 12);
+      sparks.burst(col, toFixed16(r * 0.5f), 24, toFixed16(r * 1.5f), color, lifeMs);
+    }
+    diff >>= 1;
+    keys >>= 1;
+  }
+}
+
+//##################################################
+// Animation Player, decodes a stored animation
+//##################################################
+
+AnimationPlayer::AnimationPlayer(const uint8_t* anim, uint32_t animSize) {
+  data = anim;
+  size = animSize;
+  playing = false;
+}
+
+void AnimationPlayer::setup(Pixel* pix, uint32_t radius, uint32_t diameter) {
+  r = radius;
+  d = diameter;
+  pixels = pix;
+  vecFill(Colors::Black, pixels, r * d);
+  playing = anim.open(data, size) && anim.rings() == r && anim.cols() == d;
+  if (playing)
+    anim.decodeFrame(pixels); // frame 0 is a keyframe
+  lastUs = micros();
+}
+
+void AnimationPlayer::tick() {
+  TGRAPHICS_PROBE("AnimationPlayer::tick");
+  if (!playing)
+    return;
+  if (anim.frameUs() == 0) { // no rate recorded, a frame per tick
+    anim.decodeFrame(pixels);
+    return;
+  }
+  uint32_t now = micros();
+  // frames are deltas, so every one has to be decoded; if we fell more than a few
+  // behind, drop the lost time instead of trying to catch up
+  if (now - lastUs > 4 * anim.frameUs())
+    lastUs = now - anim.frameUs();
+  while (now - lastUs >= anim.frameUs()) {
+    anim.decodeFrame(pixels);
+    lastUs += anim.frameUs();
+  }
+}
+
+void AnimationPlayer::processKeypress(uint16_t keys, uint16_t diff) {
+  if (!playing)
+    return;
+  for (uint32_t i = 0; i < 12; i++) {
+    if ((diff & 1) && (keys & 1)) {
+      anim.seek(i * anim.frames() / 12, pixels);
+      anim.decodeFrame(pixels);
+      lastUs = micros();
+      break;
+    }
+    diff >>= 1;
+    keys >>= 1;
+  }
 }
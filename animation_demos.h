@@ -1,6 +1,10 @@
 #ifndef __ANIMATION_DEMOS_H
 #define __ANIMATION_DEMOS_H
 #include "tgraphics.h"
+#include "column_scheduler.h"
+#include "particles.h"
+#include "oscillators.h"
+#include "animation_stream.h"
 #include <cstdint>
 
 // How a demo works
@@ -8,11 +12,22 @@
 
 // void demo_XXX.updateArray(...); // generates next full-frame of pixel data
 
+// With a ColumnScheduler, demo_XXX.update(sched) advances the animation and marks the
+// columns that changed, then the scheduler calls demo_XXX.renderColumns(first, count)
+// for those columns, closest to the sweep first.
+
 class Demo {
   public:
     virtual void setup(Pixel* pixels, uint32_t radius, uint32_t diameter);
     virtual void tick();
     virtual void processKeypress(uint16_t keys, uint16_t diff);
+    // Defaults: update() just calls tick(), renderColumns() draws nothing
+    virtual void update(ColumnScheduler& sched);
+    virtual void renderColumns(uint32_t firstCol, uint32_t numCols);
+    // 16.16 columns the display should rotate the buffer by (RotatedView::setRotation)
+    virtual uint32_t rotation() const;
+    // Point the demo at a new buffer (e.g. FrameChain::back()) without re-running setup
+    void setBuffer(Pixel* pix);
   protected:
     uint32_t r;
     uint32_t d;
@@ -26,7 +41,10 @@ class SimpleFlash : public Demo {
     void setup(Pixel* pixels, uint32_t radius, uint32_t diameter);
     void tick();
     void processKeypress(uint16_t keys, uint16_t diff);
+    void update(ColumnScheduler& sched);
+    void renderColumns(uint32_t firstCol, uint32_t numCols);
   private:
+    bool advance();
     SimpleTimer timer;
     Pixel* palette;
     Pixel flashColor;
@@ -34,25 +52,39 @@ class SimpleFlash : public Demo {
     uint16_t paletteLength;
     uint32_t delayInUs;
     bool flip;
-    float brightness;
+    Scale16 brightness;
 };
 
 
 // Rainbow Demo
 class RainbowWheel : public Demo {
   public:
-    RainbowWheel(float brightness);
+    // rotates by one column every frameTime us, 0 = no rotation
+    // By default the wheel is redrawn turned whenever it moves a whole column, so it spins
+    // on any output path. See setRotationAware() to draw it once and only move rotation().
+    RainbowWheel(float brightness, uint32_t frameTime = 0);
     void setup(Pixel* pixels, uint32_t w, uint32_t h);
     void tick();
     void processKeypress(uint16_t keys, uint16_t diff);
+    void update(ColumnScheduler& sched);
+    void renderColumns(uint32_t firstCol, uint32_t numCols);
+    uint32_t rotation() const;
+    // true when the buffer is read through a RotatedView set to rotation() (or a Compositor
+    // layer rotation): the wheel is then drawn once and turns smoothly between columns
+    void setRotationAware(bool aware);
   private:
-    SimpleTimer timer;
-    int rainbowOffset;
+    void advance();
+    uint32_t wantedShift() const;
+    uint32_t rainbowOffset; // 16.16 columns
+    uint32_t drawnShift; // whole columns the buffer is drawn turned by
+    uint32_t lastUs;
+    uint32_t remainder; // sub-column time left over, so rotation doesn't drift
     uint32_t frameTime;
-    float brightness;
+    Scale16 brightness;
+    bool rotationAware;
 };
 
-// Oscillating ring
+// Oscillating ring, moves in and out, each key picks its color
 class RingDemo : public Demo {
   public:
     RingDemo(float brightness, uint32_t frameTime);
@@ -62,7 +94,44 @@ class RingDemo : public Demo {
   private:
     SimpleTimer timer;
     uint32_t frameTime;
-    float brightness;
+    Scale16 brightness;
+    OscillatorClock clock;
+    Oscillator wave;
+    Pixel color;
+    int32_t center; // 16.16 ring drawn last frame
+};
+
+// Fireworks, a burst of sparks for every key press
+class Fireworks : public Demo {
+  public:
+    Fireworks(float brightness, uint32_t lifeMs = 1500);
+    void setup(Pixel* pixels, uint32_t w, uint32_t h);
+    void tick();
+    void processKeypress(uint16_t keys, uint16_t diff);
+  private:
+    static const uint32_t TrailUs = 250000;
+    ParticlePool<256> sparks;
+    uint32_t lastUs;
+    uint32_t fadeCarry; // fade owed from earlier ticks, in 1/TrailUs channel units
+    uint32_t lifeMs;
+    Scale16 brightness;
+};
+
+// Plays a precomputed animation (animation_stream.h) at the rate it was recorded at,
+// key i jumps to i/12 of the way through. Nothing plays if the animation was recorded
+// for a different rings x columns
+class AnimationPlayer : public Demo {
+  public:
+    AnimationPlayer(const uint8_t* data, uint32_t size);
+    void setup(Pixel* pixels, uint32_t w, uint32_t h);
+    void tick();
+    void processKeypress(uint16_t keys, uint16_t diff);
+  private:
+    AnimationDecoder anim;
+    const uint8_t* data;
+    uint32_t size;
+    uint32_t lastUs;
+    bool playing;
 };
 
 #endif // ifndef __ANIMATION_DEMOS_H
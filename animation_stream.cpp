@@ -0,0 +1,141 @@
+#include "animation_stream.h"
+#include <cstring>
+
+static inline uint32_t read16(const uint8_t* p) {
+  return p[0] | (uint32_t)p[1] << 8;
+}
+
+static inline uint32_t read32(const uint8_t* p) {
+  return read16(p) | read16(p + 2) << 16;
+}
+
+AnimationDecoder::AnimationDecoder() {
+  start = nullptr;
+  end = nullptr;
+  numRings = numCols = numFrames = 0;
+  keyInterval = 1;
+  numColors = 0;
+  usPerFrame = 0;
+  curFrame = curCol = skipCols = 0;
+}
+
+bool AnimationDecoder::open(const uint8_t* data, uint32_t size) {
+  start = nullptr;
+  if (size < AnimationHeaderSize || memcmp(data, "TGAN", 4) != 0 || data[4] != AnimationVersion)
+    return false;
+  numRings = read16(data + 6);
+  numCols = read16(data + 8);
+  numFrames = read16(data + 10);
+  keyInterval = read16(data + 12);
+  numColors = read16(data + 14);
+  usPerFrame = read32(data + 16);
+  if (!numRings || !numCols || !numFrames || !keyInterval || !numColors || numColors > 256)
+    return false;
+
+  palette = data + AnimationHeaderSize;
+  keyframes = palette + numColors * PaletteColorBytes;
+  uint32_t numKeys = (numFrames + keyInterval - 1) / keyInterval;
+  if ((uint32_t)(keyframes - data) + numKeys * 4 > size)
+    return false;
+  for (uint32_t k = 0; k < numKeys; k++) {
+    if (read32(keyframes + 4 * k) >= size)
+      return false;
+  }
+  start = data;
+  end = data + size;
+  startFrame(0);
+  return true;
+}
+
+// Stored blue, green, red whatever order Pixels are kept in. Indices past the palette
+// (only in a corrupt stream) clamp to the last entry, open() checked that much is there
+Pixel AnimationDecoder::paletteColor(uint8_t i) const {
+  if (i >= numColors)
+    i = numColors - 1;
+  const uint8_t* c = palette + i * PaletteColorBytes;
+  return { (uint16_t)read16(c), (uint16_t)read16(c + 2), (uint16_t)read16(c + 4) };
+}
+
+uint32_t AnimationDecoder::keyframeOffset(uint32_t key) const {
+  return read32(keyframes + 4 * key);
+}
+
+void AnimationDecoder::startFrame(uint32_t frame) {
+  curFrame = frame;
+  curCol = 0;
+  skipCols = 0;
+  if (frame % keyInterval == 0)
+    pos = start + keyframeOffset(frame / keyInterval);
+}
+
+void AnimationDecoder::nextColumn() {
+  if (++curCol < numCols)
+    return;
+  startFrame(curFrame + 1 < numFrames ? curFrame + 1 : 0);
+}
+
+bool AnimationDecoder::decodeColumn(Pixel* column) {
+  if (!valid())
+    return false;
+  if (skipCols) {
+    skipCols--;
+    nextColumn();
+    return false;
+  }
+  if (pos < end && *pos >= OpSkipCols) {
+    skipCols = *pos++ & 0x3f; // the columns after this one
+    nextColumn();
+    return false;
+  }
+
+  // a corrupt stream can't write past the column or read past the end (or the
+  // palette), it just decodes garbage
+  bool changed = false;
+  uint32_t ring = 0;
+  while (ring < numRings && pos < end) {
+    uint8_t op = *pos++;
+    uint32_t count = (op & 0x3f) + 1;
+    uint32_t n = count < numRings - ring ? count : numRings - ring;
+    if (op >= OpSkipCols) {
+      break;
+    } else if (op >= OpLiteral) {
+      if (count > (uint32_t)(end - pos))
+        break;
+      for (uint32_t i = 0; i < n; i++)
+        column[ring + i] = paletteColor(pos[i]);
+      pos += count;
+      changed = true;
+    } else if (op >= OpRun) {
+      if (pos == end)
+        break;
+      vecFill(paletteColor(*pos++), column + ring, n);
+      changed = true;
+    }
+    ring += n;
+  }
+  nextColumn();
+  return changed;
+}
+
+void AnimationDecoder::decodeFrame(Pixel* pixels, ColumnBitmap* changed) {
+  TGRAPHICS_PROBE("AnimationDecoder::decodeFrame");
+  if (!valid())
+    return;
+  uint32_t frame = curFrame;
+  while (curFrame == frame) {
+    uint32_t col = curCol;
+    if (decodeColumn(pixels + indexAt(numRings, col, 0)) && changed)
+      changed->set(col);
+    if (numFrames == 1 && curCol == 0)
+      break; // a single frame loops onto itself
+  }
+}
+
+void AnimationDecoder::seek(uint32_t frame, Pixel* pixels) {
+  if (!valid())
+    return;
+  frame %= numFrames;
+  startFrame(frame - frame % keyInterval);
+  while (curFrame != frame)
+    decodeFrame(pixels);
+}
@@ -0,0 +1,100 @@
+#ifndef __ANIMATION_STREAM_H
+#define __ANIMATION_STREAM_H
+#include "tgraphics.h"
+#include "column_scheduler.h" // ColumnBitmap
+#include <cstdint>
+
+// Precomputed animations, compressed to fit in flash
+// Every pixel is an index into a palette of up to 256 colors, and every frame is coded
+// column by column as a change from the frame before it, so the decoder writes straight
+// into the display buffer (which already holds the previous frame) with no scratch
+// frame. Every keyframeInterval frames is a keyframe that writes every pixel, so playback
+// can seek (decode the keyframe, then the frames after it) and loop.
+// Animations are made on the host by extras/tools/tgraphics_encode from any Demo.
+//
+//   #include "spiral_anim.h" // const uint8_t spiralAnim[] from tgraphics_encode
+//   AnimationDecoder anim;
+//   anim.open(spiralAnim, sizeof(spiralAnim));
+//   ...every anim.frameUs():
+//   anim.decodeFrame(pixels);
+
+/*-- Container, little endian:
+
+    0   'T' 'G' 'A' 'N'
+    4   version (1), flags (0)
+    6   rings, cols, frames, keyframeInterval, paletteSize      (uint16 each)
+    16  frameUs                                                 (uint32)
+    20  palette: paletteSize x { blue, green, red }             (uint16 each)
+    ..  keyframe offsets from the start: ceil(frames / keyframeInterval) x uint32
+    ..  frames, each one cols columns of ops
+
+    Column ops, one byte each with a count n = (op & 0x3f) + 1 (1 - 64):
+    00nnnnnn  Skip     n rings are unchanged
+    01nnnnnn  Run      next byte is a palette index for n rings
+    10nnnnnn  Literal  the next n bytes are palette indices, one per ring
+    11nnnnnn  SkipCols this column and the n - 1 after it are unchanged (column start only)
+
+*/
+
+const uint32_t AnimationHeaderSize = 20;
+const uint32_t PaletteColorBytes = 6;
+const uint8_t AnimationVersion = 1;
+
+const uint8_t OpSkip = 0x00;
+const uint8_t OpRun = 0x40;
+const uint8_t OpLiteral = 0x80;
+const uint8_t OpSkipCols = 0xc0;
+const uint32_t MaxOpCount = 64;
+
+class AnimationDecoder {
+  public:
+    AnimationDecoder();
+
+    // False (and nothing decodes) if data isn't a complete container
+    bool open(const uint8_t* data, uint32_t size);
+    bool valid() const { return start != nullptr; }
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    uint32_t frames() const { return numFrames; }
+    uint32_t frameUs() const { return usPerFrame; }
+    uint32_t keyframeInterval() const { return keyInterval; }
+    uint32_t paletteSize() const { return numColors; }
+    Pixel paletteColor(uint8_t i) const;
+
+    // Frame the next decodeColumn() belongs to, and its column
+    uint32_t frame() const { return curFrame; }
+    uint32_t column() const { return curCol; }
+
+    // Decodes the next column into column (rings() pixels), then moves on to the next
+    // column, frame, or back to frame 0 after the last one. False if it was unchanged
+    bool decodeColumn(Pixel* column);
+    // The rest of the current frame (all of it from column 0) into a buffer laid out
+    // with indexAt. changed (if given) gets the columns that were written
+    void decodeFrame(Pixel* pixels, ColumnBitmap* changed = nullptr);
+    // Jumps to the start of frame: decodes the keyframe before it and the frames in
+    // between into pixels
+    void seek(uint32_t frame, Pixel* pixels);
+
+  private:
+    uint32_t keyframeOffset(uint32_t key) const;
+    void startFrame(uint32_t frame);
+    void nextColumn();
+
+    const uint8_t* start; // whole container
+    const uint8_t* end;
+    const uint8_t* palette;
+    const uint8_t* keyframes;
+    const uint8_t* pos;   // next op
+    uint32_t numRings;
+    uint32_t numCols;
+    uint32_t numFrames;
+    uint32_t keyInterval;
+    uint32_t numColors;
+    uint32_t usPerFrame;
+    uint32_t curFrame;
+    uint32_t curCol;
+    uint32_t skipCols;    // unchanged columns left from a SkipCols op
+};
+
+#endif // ifndef __ANIMATION_STREAM_H
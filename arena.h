@@ -0,0 +1,47 @@
+#ifndef __ARENA_H
+#define __ARENA_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Fixed pool of Pixels handed out as scratch buffers, no heap
+// Allocation just bumps an offset. Take a mark() before borrowing buffers and
+// release(mark) to hand back everything allocated after it.
+
+class PixelArena {
+  public:
+    PixelArena(Pixel* storage, uint32_t numPixels) {
+      pool = storage;
+      size = numPixels;
+      used = 0;
+    }
+
+    // nullptr when there isn't room
+    Pixel* alloc(uint32_t numPixels) {
+      if (numPixels > size - used)
+        return nullptr;
+      Pixel* p = pool + used;
+      used += numPixels;
+      return p;
+    }
+
+    uint32_t mark() const { return used; }
+    void release(uint32_t mark) { used = mark < used ? mark : used; }
+    void reset() { used = 0; }
+    uint32_t available() const { return size - used; }
+    uint32_t capacity() const { return size; }
+
+  private:
+    Pixel* pool;
+    uint32_t size;
+    uint32_t used;
+};
+
+template <uint32_t NumPixels>
+class StaticPixelArena : public PixelArena {
+  public:
+    StaticPixelArena() : PixelArena(storage, NumPixels) {}
+  private:
+    Pixel storage[NumPixels];
+};
+
+#endif // ifndef __ARENA_H
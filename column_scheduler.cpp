@@ -0,0 +1,142 @@
+#include "column_scheduler.h"
+#include "animation_demos.h" // Demo
+#include <Arduino.h> // micros
+#include <cstring>
+
+ColumnBitmap::ColumnBitmap() {
+  clearAll();
+}
+
+void ColumnBitmap::setRange(uint32_t first, uint32_t count) {
+  for (uint32_t col = first; col < first + count; col++)
+    set(col);
+}
+
+void ColumnBitmap::clearRange(uint32_t first, uint32_t count) {
+  for (uint32_t col = first; col < first + count; col++)
+    clear(col);
+}
+
+void ColumnBitmap::setAll(uint32_t numCols) {
+  clearAll();
+  memset(bits, 0xff, (numCols / 32) * sizeof(uint32_t));
+  if (numCols & 31)
+    bits[numCols / 32] = (1u << (numCols & 31)) - 1;
+}
+
+void ColumnBitmap::clearAll() {
+  memset(bits, 0, sizeof(bits));
+}
+
+uint32_t ColumnBitmap::findNext(uint32_t from, uint32_t limit) const {
+  while (from < limit) {
+    uint32_t word = bits[from >> 5] >> (from & 31);
+    if (word) {
+      from += __builtin_ctz(word);
+      return from < limit ? from : limit;
+    }
+    from = (from | 31) + 1; // next word
+  }
+  return limit;
+}
+
+ColumnScheduler::ColumnScheduler(uint32_t cols, uint32_t leadColumns) {
+  numCols = cols > MaxSweepColumns ? MaxSweepColumns : cols;
+  lead = leadColumns;
+  maxRunColumns = 8;
+  syncColumn.store(0);
+  syncUs.store(micros());
+  usPerCol.store(0);
+  resetStats();
+}
+
+void ColumnScheduler::sync(uint32_t column, uint32_t nowUs) {
+  syncUs.store(nowUs, std::memory_order_relaxed);
+  syncColumn.store(column, std::memory_order_relaxed);
+}
+
+void ColumnScheduler::setUsPerRevolution(uint32_t usPerRev) {
+  usPerCol.store(usPerRev / numCols, std::memory_order_relaxed);
+}
+
+SweepPosition ColumnScheduler::position() const {
+  uint32_t perCol = usPerCol.load(std::memory_order_relaxed);
+  uint32_t col = syncColumn.load(std::memory_order_relaxed);
+  if (perCol)
+    col += (micros() - syncUs.load(std::memory_order_relaxed)) / perCol;
+  return { col % numCols, perCol };
+}
+
+uint32_t ColumnScheduler::deadline(uint32_t col) const {
+  SweepPosition pos = position();
+  uint32_t ahead = (col + numCols - pos.column) % numCols;
+  if (ahead == 0)
+    ahead = numCols; // being lit now, next chance is a revolution away
+  return micros() + ahead * pos.usPerColumn;
+}
+
+void ColumnScheduler::markDirty(uint32_t col) {
+  dirty.set(col % numCols);
+}
+
+void ColumnScheduler::markDirty(uint32_t first, uint32_t count) {
+  if (count >= numCols) {
+    markAllDirty();
+    return;
+  }
+  first %= numCols;
+  uint32_t tail = numCols - first;
+  if (count <= tail) {
+    dirty.setRange(first, count);
+  } else {
+    dirty.setRange(first, tail);
+    dirty.setRange(0, count - tail);
+  }
+}
+
+void ColumnScheduler::markAllDirty() {
+  dirty.setAll(numCols);
+}
+
+uint32_t ColumnScheduler::service(Demo& demo, uint32_t budgetUs) {
+  TGRAPHICS_PROBE("ColumnScheduler::service");
+  demo.update(*this);
+
+  uint32_t startUs = micros();
+  SweepPosition pos = position();
+  uint32_t first = (pos.column + lead) % numCols;
+  uint32_t count = 0;
+
+  // two contiguous passes, [first, numCols) then [0, first), so runs never wrap
+  for (uint32_t pass = 0; pass < 2; pass++) {
+    uint32_t col = pass == 0 ? first : 0;
+    uint32_t limit = pass == 0 ? numCols : first;
+    while ((col = dirty.findNext(col, limit)) < limit) {
+      uint32_t run = 1;
+      while (run < maxRunColumns && col + run < limit && dirty.test(col + run))
+        run++;
+
+      demo.renderColumns(col, run);
+      dirty.clearRange(col, run);
+      count += run;
+
+      // this run's first column is lit ahead * usPerColumn after we started
+      uint32_t ahead = (col + numCols - pos.column) % numCols;
+      if (pos.usPerColumn && micros() - startUs > ahead * pos.usPerColumn)
+        late += run;
+
+      col += run;
+      if (budgetUs && micros() - startUs >= budgetUs) {
+        rendered += count;
+        return count;
+      }
+    }
+  }
+  rendered += count;
+  return count;
+}
+
+void ColumnScheduler::resetStats() {
+  late = 0;
+  rendered = 0;
+}
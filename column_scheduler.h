@@ -0,0 +1,90 @@
+#ifndef __COLUMN_SCHEDULER_H
+#define __COLUMN_SCHEDULER_H
+#include <atomic>
+#include <cstdint>
+
+class Demo;
+
+// Race-the-beam rendering: only the column about to be lit has a hard deadline, so
+// instead of regenerating the whole buffer every tick, demos mark the columns that
+// changed and the scheduler renders them in deadline order, starting just ahead of
+// the sweep. Unchanged columns are never touched.
+
+/*-- Deadline order for a sweep at column s (lead = 1):
+
+        s+1, s+2, ... numCols-1, 0, 1, ... s     <- render order
+        ^ lit next                         ^ lit a whole revolution from now
+
+*/
+
+const uint32_t MaxSweepColumns = 1024;
+
+// Fixed size bitmap of dirty columns
+class ColumnBitmap {
+  public:
+    ColumnBitmap();
+    void set(uint32_t col) { bits[col >> 5] |= 1u << (col & 31); }
+    void clear(uint32_t col) { bits[col >> 5] &= ~(1u << (col & 31)); }
+    bool test(uint32_t col) const { return bits[col >> 5] & (1u << (col & 31)); }
+    void setRange(uint32_t first, uint32_t count); // no wrap, first + count <= MaxSweepColumns
+    void clearRange(uint32_t first, uint32_t count);
+    void setAll(uint32_t numCols);
+    void clearAll();
+    // First set bit in [from, limit), or limit if there is none
+    uint32_t findNext(uint32_t from, uint32_t limit) const;
+
+  private:
+    uint32_t bits[MaxSweepColumns / 32];
+};
+
+struct SweepPosition {
+  uint32_t column;     // column currently being lit
+  uint32_t usPerColumn;
+};
+
+class ColumnScheduler {
+  public:
+    ColumnScheduler(uint32_t numCols, uint32_t leadColumns = 1);
+
+    //------ Display side (ISR) ------//
+
+    // Call whenever the display knows where it is, e.g. column 0 on the hall sensor
+    void sync(uint32_t column, uint32_t nowUs);
+    void setUsPerRevolution(uint32_t usPerRev);
+
+    //------ Render side ------//
+
+    // Estimated sweep position right now
+    SweepPosition position() const;
+    // micros() value at which col will next be lit
+    uint32_t deadline(uint32_t col) const;
+
+    void markDirty(uint32_t col);
+    void markDirty(uint32_t first, uint32_t count); // wraps around the end of the sweep
+    void markAllDirty();
+    bool isDirty(uint32_t col) const { return dirty.test(col); }
+
+    // One scheduling pass: demo.update(*this), then demo.renderColumns() for dirty
+    // columns in deadline order. Stops after budgetUs (0 = no limit), returns the
+    // number of columns rendered.
+    uint32_t service(Demo& demo, uint32_t budgetUs = 0);
+
+    uint32_t columns() const { return numCols; }
+    uint32_t lateColumns() const { return late; }        // rendered after their deadline
+    uint32_t renderedColumns() const { return rendered; }
+    void resetStats();
+
+    uint32_t maxRunColumns; // columns per renderColumns() call, bounds budget overshoot
+
+  private:
+    uint32_t numCols;
+    uint32_t lead;
+    ColumnBitmap dirty;
+    std::atomic<uint32_t> syncColumn;
+    std::atomic<uint32_t> syncUs;
+    std::atomic<uint32_t> usPerCol;
+    uint32_t late;
+    uint32_t rendered;
+};
+
+#endif // ifndef __COLUMN_SCHEDULER_H
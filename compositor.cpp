@@ -0,0 +1,147 @@
+#include "compositor.h"
+
+// Blend kernels, all channel-wise over a column as 3 * rings uint16_t
+
+static void blendMax(const uint16_t* src, uint16_t* dst, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = src[i] > dst[i] ? src[i] : dst[i];
+}
+
+// src is a mask on the color scale: 0xff (Colors::White) * x stays x, anything brighter
+// counts as white. The constant divide compiles to a multiply and shift
+static void blendMultiply(const uint16_t* src, uint16_t* dst, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    uint32_t s = src[i] > 0xff ? 0xff : src[i];
+    dst[i] = (uint16_t)(s * dst[i] / 0xff);
+  }
+}
+
+// alpha < AlphaOpaque. Both weights as Q16 (high half multiplies)
+static void blendAlpha(const uint16_t* src, uint16_t* dst, uint32_t n, uint32_t alpha) {
+  uint16_t a = alpha << 8, inv = (AlphaOpaque - alpha) << 8; // 1 <= alpha <= 255
+  for (uint32_t i = 0; i < n; i++)
+    dst[i] = (uint16_t)(((uint32_t)src[i] * a) >> 16) + (uint16_t)(((uint32_t)dst[i] * inv) >> 16);
+}
+
+// The bottom layer goes onto black
+static void blendFirst(const Layer& l, const uint16_t* src, uint16_t* dst, uint32_t n) {
+  if (l.mode == BlendMode::Multiply)
+    memset(dst, 0, n * sizeof(uint16_t));
+  else if (l.mode == BlendMode::Alpha && l.alpha < AlphaOpaque)
+    vecScale(src, dst, { l.alpha }, n); // Q8 alpha is already a Scale16
+  else
+    memcpy(dst, src, n * sizeof(uint16_t));
+}
+
+static void blend(const Layer& l, const uint16_t* src, uint16_t* dst, uint32_t n) {
+  switch (l.mode) {
+    case BlendMode::Add:
+      vecQAdd16(dst, src, dst, n);
+      break;
+    case BlendMode::Max:
+      blendMax(src, dst, n);
+      break;
+    case BlendMode::Multiply:
+      blendMultiply(src, dst, n);
+      break;
+    case BlendMode::Alpha:
+      if (l.alpha == AlphaOpaque)
+        memcpy(dst, src, n * sizeof(uint16_t));
+      else
+        blendAlpha(src, dst, n, l.alpha);
+      break;
+  }
+}
+
+Compositor::Compositor(uint32_t rings, uint32_t cols) {
+  numRings = rings;
+  numCols = cols;
+  numLayers = 0;
+}
+
+int Compositor::addLayer(const Pixel* pixels, BlendMode mode, uint16_t alpha) {
+  if (numLayers == MaxLayers)
+    return -1;
+  Layer& l = stack[numLayers];
+  l.pixels = pixels;
+  l.coverage = nullptr;
+  l.rotation = 0;
+  l.alpha = alpha > AlphaOpaque ? AlphaOpaque : alpha;
+  l.mode = mode;
+  l.enabled = true;
+  return numLayers++;
+}
+
+bool Compositor::visible(const Layer& l) const {
+  return l.enabled && l.pixels && !(l.mode == BlendMode::Alpha && l.alpha == 0);
+}
+
+// Columns [col, col + count) where every layer has the same coverage and none wraps
+void Compositor::composeRun(Pixel* dst, uint32_t col, uint32_t count, const Layer** active, uint32_t numActive) const {
+  uint16_t* out = (uint16_t*)(dst + indexAt(numRings, col, 0));
+  uint32_t n = 3 * numRings * count;
+  bool first = true;
+  for (uint32_t i = 0; i < numActive; i++) {
+    const Layer& l = *active[i];
+    uint32_t srcCol = sourceColumn(l, col);
+    if (l.coverage && !l.coverage->test(srcCol))
+      continue; // transparent here
+    const uint16_t* src = (const uint16_t*)(l.pixels + indexAt(numRings, srcCol, 0));
+    if (first)
+      blendFirst(l, src, out, n);
+    else
+      blend(l, src, out, n);
+    first = false;
+  }
+  if (first) // nothing covers these columns
+    memset(out, 0, n * sizeof(uint16_t));
+}
+
+// How many columns from col can go through composeRun together, at most limit
+uint32_t Compositor::runLength(uint32_t col, uint32_t limit, const Layer** active, uint32_t numActive) const {
+  if (col + limit > numCols)
+    limit = numCols - col;
+  for (uint32_t i = 0; i < numActive; i++) {
+    const Layer& l = *active[i];
+    uint32_t srcCol = sourceColumn(l, col);
+    if (srcCol + limit > numCols)
+      limit = numCols - srcCol; // the layer wraps back to column 0
+    if (!l.coverage)
+      continue;
+    bool covered = l.coverage->test(srcCol);
+    for (uint32_t c = 1; c < limit; c++) {
+      if (l.coverage->test(srcCol + c) != covered) {
+        limit = c;
+        break;
+      }
+    }
+  }
+  return limit;
+}
+
+void Compositor::composeColumns(Pixel* dst, uint32_t firstCol, uint32_t count) const {
+  TGRAPHICS_PROBE("Compositor::compose");
+  // Layers that can't contribute anything are dropped once, not per column
+  const Layer* active[MaxLayers];
+  uint32_t numActive = 0;
+  for (uint32_t i = 0; i < numLayers; i++) {
+    if (visible(stack[i]))
+      active[numActive++] = &stack[i];
+  }
+  if (count > numCols)
+    count = numCols;
+  // Runs stay small enough that every layer's part of it is still cached for the next
+  uint32_t maxRun = numRings < RunPixels ? RunPixels / numRings : 1;
+  uint32_t col = firstCol % numCols;
+  while (count) {
+    uint32_t len = runLength(col, count < maxRun ? count : maxRun, active, numActive);
+    composeRun(dst, col, len, active, numActive);
+    count -= len;
+    col += len;
+    col = col == numCols ? 0 : col;
+  }
+}
+
+void Compositor::compose(Pixel* dst) const {
+  composeColumns(dst, 0, numCols);
+}
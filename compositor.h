@@ -0,0 +1,77 @@
+#ifndef __COMPOSITOR_H
+#define __COMPOSITOR_H
+#include "tgraphics.h"
+#include "column_scheduler.h" // ColumnBitmap
+#include <cstdint>
+
+// Stacks several Pixel buffers (all laid out with indexAt, same size) into one
+// Layers are applied bottom to top. The output is built one column at a time: the
+// column is written by the bottom layer and every layer above blends into it while it's
+// still in cache, so the frame is walked once no matter how many layers there are.
+// Layers that are disabled or fully transparent are skipped, so are the columns a
+// layer doesn't cover (see setCoverage).
+//
+//   Compositor comp(rings, cols);
+//   comp.addLayer(background);                 // e.g. a RainbowWheel's buffer
+//   comp.addLayer(sparks, BlendMode::Add);     // particles on top
+//   comp.compose(pixels);
+
+enum class BlendMode : uint8_t {
+  Add,      // saturating, like Pixel::operator+
+  Max,      // brightest channel wins
+  Multiply, // Colors::White (0xff) leaves the layer below alone, black clears it
+  Alpha,    // layer * alpha + below * (1 - alpha)
+};
+
+const uint32_t MaxLayers = 8;
+const uint16_t AlphaOpaque = 256; // Q8
+
+struct Layer {
+  const Pixel* pixels;
+  const ColumnBitmap* coverage; // nullptr: every column
+  uint32_t rotation;            // whole columns, see RotatedView
+  uint16_t alpha;               // Q8, only for BlendMode::Alpha
+  BlendMode mode;
+  bool enabled;
+};
+
+class Compositor {
+  public:
+    Compositor(uint32_t rings, uint32_t cols);
+
+    // Returns the layer's index, or -1 if there are already MaxLayers
+    int addLayer(const Pixel* pixels, BlendMode mode = BlendMode::Alpha, uint16_t alpha = AlphaOpaque);
+    void clearLayers() { numLayers = 0; }
+    uint32_t layers() const { return numLayers; }
+    Layer& layer(uint32_t i) { return stack[i]; }
+
+    void setMode(uint32_t i, BlendMode mode) { stack[i].mode = mode; }
+    void setAlpha(uint32_t i, uint16_t alpha) { stack[i].alpha = alpha > AlphaOpaque ? AlphaOpaque : alpha; }
+    void setEnabled(uint32_t i, bool enabled) { stack[i].enabled = enabled; }
+    // Columns of this layer that can be non-transparent, the rest are skipped
+    void setCoverage(uint32_t i, const ColumnBitmap* columns) { stack[i].coverage = columns; }
+    // Read this layer rotated, output column c comes from layer column c + rotation
+    void setRotation(uint32_t i, uint32_t cols) { stack[i].rotation = cols % numCols; }
+
+    // dst may not be one of the layers
+    void compose(Pixel* dst) const;
+    void composeColumns(Pixel* dst, uint32_t firstCol, uint32_t count) const;
+
+  private:
+    static const uint32_t RunPixels = 512; // per layer, 3KB
+
+    bool visible(const Layer& l) const;
+    uint32_t sourceColumn(const Layer& l, uint32_t col) const {
+      uint32_t c = col + l.rotation;
+      return c >= numCols ? c - numCols : c;
+    }
+    uint32_t runLength(uint32_t col, uint32_t limit, const Layer** active, uint32_t numActive) const;
+    void composeRun(Pixel* dst, uint32_t col, uint32_t count, const Layer** active, uint32_t numActive) const;
+
+    Layer stack[MaxLayers];
+    uint32_t numLayers;
+    uint32_t numRings;
+    uint32_t numCols;
+};
+
+#endif // ifndef __COMPOSITOR_H
@@ -0,0 +1,166 @@
+#ifndef __DEMO_REGISTRY_H
+#define __DEMO_REGISTRY_H
+#include "animation_demos.h"
+#include <algorithm> // std::max
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new> // placement new
+#include <type_traits>
+#include <utility>
+
+// Compile-time list of demos sharing one statically sized slot
+// The slot is as big (and as aligned) as the largest demo in the list, so switching
+// demos never touches the heap: the running demo is destroyed in place and the next one
+// is constructed over it. Calls go through a table of per-type thunks that call the
+// concrete D::tick() etc. directly (no virtual dispatch), so small bodies get inlined.
+//
+//   DemoRegistry<SimpleFlash, RainbowWheel, RingDemo, Fireworks> demos;
+//   ...on keypress:
+//   demos.emplace<RainbowWheel>(0.5f, 20000);
+//   demos.setup(pixels, rings, cols);
+//   ...every frame:
+//   demos.tick();
+//
+// demo() gives a plain Demo* for the ColumnScheduler or a Transition (which needs the
+// outgoing and incoming demo alive at once, so use two registries).
+//
+// Sticks to C++14 (the Teensy 3.x core builds with gnu++14): no fold expressions or
+// inline variables, std::launder only when the standard library has it.
+
+// True if every entry is, stands in for a fold expression over a pack
+constexpr bool allOf(std::initializer_list<bool> values) {
+  for (bool v : values) {
+    if (!v)
+      return false;
+  }
+  return true;
+}
+
+template <typename... Demos>
+class DemoRegistry {
+  static_assert(sizeof...(Demos) > 0, "DemoRegistry needs at least one demo");
+  static_assert(allOf({ std::is_base_of<Demo, Demos>::value... }), "DemoRegistry entries must derive from Demo");
+
+  public:
+    static const uint32_t None = 0xffffffff;
+    static constexpr uint32_t count = sizeof...(Demos);
+    static constexpr size_t slotSize = std::max({ sizeof(Demos)... });
+
+    // Index of D in the list, None if it isn't there
+    template <typename D>
+    static constexpr uint32_t indexOf() {
+      constexpr bool match[] = { std::is_same<D, Demos>::value... };
+      for (uint32_t i = 0; i < count; i++) {
+        if (match[i])
+          return i;
+      }
+      return None;
+    }
+
+    DemoRegistry() { current = None; }
+    ~DemoRegistry() { clear(); }
+    DemoRegistry(const DemoRegistry&) = delete;
+    DemoRegistry& operator=(const DemoRegistry&) = delete;
+
+    // Tears down the running demo and constructs D in its place (call setup() next)
+    template <typename D, typename... Args>
+    D& emplace(Args&&... args) {
+      static_assert(indexOf<D>() != None, "demo type isn't in this DemoRegistry");
+      clear();
+      D* d = new (slot) D(std::forward<Args>(args)...);
+      current = indexOf<D>();
+      return *d;
+    }
+
+    void clear() {
+      if (current != None) {
+        ops[current].destroy(slot);
+        current = None;
+      }
+    }
+
+    bool empty() const { return current == None; }
+    uint32_t index() const { return current; }
+
+    template <typename D>
+    D* get() {
+      return current == indexOf<D>() ? as<D>(slot) : nullptr;
+    }
+
+    Demo* demo() { return current == None ? nullptr : ops[current].base(slot); }
+
+    void setup(Pixel* pixels, uint32_t rings, uint32_t cols) {
+      if (current != None)
+        ops[current].setup(slot, pixels, rings, cols);
+    }
+    void tick() {
+      if (current != None)
+        ops[current].tick(slot);
+    }
+    void processKeypress(uint16_t keys, uint16_t diff) {
+      if (current != None)
+        ops[current].processKeypress(slot, keys, diff);
+    }
+    uint32_t rotation() const {
+      return current == None ? 0 : ops[current].rotation(slot);
+    }
+
+    // f(D&) on the running demo with its concrete type, e.g. to reach demo-specific setters
+    template <typename F>
+    void visit(F&& f) {
+      visitAt(f, std::index_sequence_for<Demos...>());
+    }
+
+  private:
+    struct Ops {
+      void (*setup)(void*, Pixel*, uint32_t, uint32_t);
+      void (*tick)(void*);
+      void (*processKeypress)(void*, uint16_t, uint16_t);
+      uint32_t (*rotation)(const void*);
+      void (*destroy)(void*);
+      Demo* (*base)(void*);
+    };
+
+    // Qualified calls, so these bind to D's own functions instead of going through the vtable
+    template <typename D>
+    static D* as(void* p) {
+#ifdef __cpp_lib_launder
+      return std::launder(reinterpret_cast<D*>(p));
+#else
+      return reinterpret_cast<D*>(p);
+#endif
+    }
+    template <typename D>
+    static void setupOf(void* p, Pixel* pix, uint32_t rings, uint32_t cols) { as<D>(p)->D::setup(pix, rings, cols); }
+    template <typename D>
+    static void tickOf(void* p) { as<D>(p)->D::tick(); }
+    template <typename D>
+    static void keypressOf(void* p, uint16_t keys, uint16_t diff) { as<D>(p)->D::processKeypress(keys, diff); }
+    template <typename D>
+    static uint32_t rotationOf(const void* p) { return as<D>(const_cast<void*>(p))->D::rotation(); }
+    template <typename D>
+    static void destroyOf(void* p) { as<D>(p)->~D(); }
+    template <typename D>
+    static Demo* baseOf(void* p) { return as<D>(p); }
+
+    static constexpr Ops ops[] = {
+      { &setupOf<Demos>, &tickOf<Demos>, &keypressOf<Demos>, &rotationOf<Demos>, &destroyOf<Demos>, &baseOf<Demos> }...
+    };
+
+    // Expands into one comparison per demo, the array only gives the pack somewhere to go
+    template <typename F, size_t... I>
+    void visitAt(F& f, std::index_sequence<I...>) {
+      int expand[] = { ((current == I ? (void)f(*as<Demos>(slot)) : (void)0), 0)... };
+      (void)expand;
+    }
+
+    alignas(Demos...) unsigned char slot[slotSize];
+    uint32_t current;
+};
+
+// ops is indexed at run time, so before C++17 it needs this out of class definition
+template <typename... Demos>
+constexpr typename DemoRegistry<Demos...>::Ops DemoRegistry<Demos...>::ops[];
+
+#endif // ifndef __DEMO_REGISTRY_H
@@ -0,0 +1,70 @@
+#ifndef __TGRAPHICS_BENCH_H
+#define __TGRAPHICS_BENCH_H
+// Tiny timing harness for the host benchmarks
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+// Realistic POV sizes: rings along the blade x columns per revolution
+struct PovSize {
+  uint32_t rings;
+  uint32_t cols;
+};
+
+const PovSize povSizes[] = {
+  { 16, 128 },
+  { 32, 256 },
+  { 64, 360 },
+};
+
+namespace bench {
+
+  // Defeat dead-code elimination of benchmark results
+  inline void keep(const void* p) {
+    asm volatile("" : : "g"(p) : "memory");
+  }
+
+  inline double& minSeconds() {
+    static double s = 0.2;
+    return s;
+  }
+
+  // Parses --quick (shorter runs for the ctest smoke run)
+  inline void parseArgs(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+      if (strcmp(argv[i], "--quick") == 0)
+        minSeconds() = 0.002;
+    }
+  }
+
+  inline void header() {
+    printf("%-34s %12s %10s %12s %14s\n", "kernel", "size", "iters", "ns/pixel", "Mpixels/s");
+  }
+
+  // Runs fn() until minSeconds() has elapsed and reports per-pixel cost
+  template <typename F>
+  void run(const char* name, const PovSize& size, F fn) {
+    using clock = std::chrono::steady_clock;
+    uint64_t pixels = (uint64_t)size.rings * size.cols;
+    uint64_t iters = 0;
+    fn(); // warm up caches and any lazily built tables
+    auto start = clock::now();
+    double elapsed = 0;
+    do {
+      for (int i = 0; i < 8; i++)
+        fn();
+      iters += 8;
+      elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    } while (elapsed < minSeconds());
+
+    double nsPerPixel = elapsed * 1e9 / (double)(iters * pixels);
+    char sizeStr[24];
+    snprintf(sizeStr, sizeof(sizeStr), "%ux%u", size.rings, size.cols);
+    printf("%-34s %12s %10llu %12.3f %14.2f\n", name, sizeStr,
+           (unsigned long long)iters, nsPerPixel, 1e3 / nsPerPixel);
+  }
+
+} // namespace bench
+
+#endif // ifndef __TGRAPHICS_BENCH_H
@@ -0,0 +1,564 @@
+// Host micro-benchmarks for the tgraphics kernels and demos.
+// Build with the top-level CMakeLists.txt and run ./tgraphics_bench [--quick]
+#include "bench.h"
+#include "tgraphics.h"
+#include "animation_demos.h"
+#include "framebuffer.h"
+#include "gradient_lut.h"
+#include "oscillators.h"
+#include "output_stage.h"
+#include "compositor.h"
+#include "particles.h"
+#include "polar_map.h"
+#include "polar_raster.h"
+#include "transition.h"
+#include "demo_registry.h"
+#include "input_queue.h"
+#include "indexed_frame.h"
+#include "rotation_view.h"
+#include "../tools/animation_encoder.h"
+
+#include <algorithm>
+#include <vector>
+
+static void fillNoise(Pixel* pix, uint32_t numElems) {
+  uint32_t seed = 0x1234567;
+  for (uint32_t i = 0; i < numElems; i++) {
+    seed = seed * 1664525 + 1013904223;
+    pix[i] = { (uint16_t)(seed >> 24), (uint16_t)(seed >> 16 & 0xff), (uint16_t)(seed >> 8 & 0xff) };
+  }
+}
+
+static void benchKernels(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> src(numPixels), dst(numPixels);
+  fillNoise(src.data(), numPixels);
+  uint16_t* src16 = (uint16_t*)src.data();
+  uint16_t* dst16 = (uint16_t*)dst.data();
+
+  // Rings are contiguous (see indexAt), so x runs along the rings and y along the columns
+  float kernel[] = { 1 / 3.0, 1 / 3.0, 1 / 3.0 };
+  bench::run("convolveSeparable 3x3", size, [&] {
+    memset(dst16, 0, numPixels * sizeof(Pixel));
+    convolveSeparable(src16, size.rings, size.cols, kernel, 3, kernel, 3, EdgeType::Black, dst16);
+    bench::keep(dst16);
+  });
+
+  bench::run("blur2d", size, [&] {
+    memset(dst16, 0, numPixels * sizeof(Pixel));
+    blur2d(src16, size.rings, size.cols, dst16);
+    bench::keep(dst16);
+  });
+
+  bench::run("vecBlur", size, [&] {
+    vecBlur(src.data(), dst.data(), 0.5f, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecFade(Pixel)", size, [&] {
+    vecFade(src.data(), dst.data(), 3, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecFade(uint16_t)", size, [&] {
+    vecFade(src16, dst16, 3, numPixels * 3);
+    bench::keep(dst16);
+  });
+
+  bench::run("vecBrighten(Pixel)", size, [&] {
+    vecBrighten(src.data(), dst.data(), 3, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecAdd(Pixel)", size, [&] {
+    vecAdd(src.data(), dst.data(), numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecFill(Pixel)", size, [&] {
+    vecFill((Pixel)Colors::DodgerBlue, dst.data(), numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecFill(Pixel*, mod)", size, [&] {
+    vecFill(rainbow12, dst.data(), numPixels, 12);
+    bench::keep(dst.data());
+  });
+
+  bench::run("rainbowAt", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      dst[i] = rainbowAt((float)i / numPixels, rainbow12, 12);
+    bench::keep(dst.data());
+  });
+
+  bench::run("GradientLUT<256>::at", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      dst[i] = rainbow12LUT.at(phaseOf(i, numPixels));
+    bench::keep(dst.data());
+  });
+
+  bench::run("GradientLUT<256>::bake", size, [&] {
+    static GradientLUT<256> lut;
+    lut.bake(rainbow12, 12);
+    bench::keep(&lut);
+  });
+
+  // one wave value per pixel, e.g. a brightness per ring and column
+  std::vector<uint16_t> wave(numPixels);
+  bench::run("beatSine16", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      wave[i] = beatSine16(0.5f, i, 0x1000, 0xf000);
+    bench::keep(wave.data());
+  });
+
+  bench::run("sine16 + scaleRange16", size, [&] {
+    static Oscillator osc(0.5f);
+    osc.advance(1000);
+    for (uint32_t i = 0; i < numPixels; i++)
+      wave[i] = scaleRange16(sine16(osc.phase + i * 0x10000), 0x1000, 0xf000);
+    bench::keep(wave.data());
+  });
+
+  bench::run("lerp_float", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      dst[i] = lerp_float(src[i], dst[i], 0.25f);
+    bench::keep(dst.data());
+  });
+
+  bench::run("lerp_uint", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      dst[i] = lerp_uint(src[i], dst[i], 0x4000);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecLerp", size, [&] {
+    vecLerp(src.data(), dst.data(), dst.data(), 0x4000, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("Pixel * float", size, [&] {
+    for (uint32_t i = 0; i < numPixels; i++)
+      dst[i] = src[i] * 0.5f;
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecScale(Pixel)", size, [&] {
+    vecScale(src.data(), dst.data(), toScale16(0.5f), numPixels);
+    bench::keep(dst.data());
+  });
+}
+
+// Same kernels at half the storage: fillNoise only makes 8-bit values, so the data matches
+static void benchPixel8(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> wide(numPixels);
+  fillNoise(wide.data(), numPixels);
+  std::vector<Pixel8> src(numPixels), dst(numPixels);
+  for (uint32_t i = 0; i < numPixels; i++)
+    src[i] = { (uint8_t)wide[i].blue, (uint8_t)wide[i].green, (uint8_t)wide[i].red };
+
+  bench::run("vecFade(Pixel8)", size, [&] {
+    vecFade(src.data(), dst.data(), 3, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecAdd(Pixel8)", size, [&] {
+    vecAdd(src.data(), dst.data(), numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("vecBlur(Pixel8)", size, [&] {
+    vecBlur(src.data(), dst.data(), 0.5f, numPixels);
+    bench::keep(dst.data());
+  });
+
+  bench::run("blur2d(Pixel8)", size, [&] {
+    blur2d((uint8_t*)src.data(), size.rings, size.cols, (uint8_t*)dst.data(), Cylindrical);
+    bench::keep(dst.data());
+  });
+
+  std::vector<uint16_t> gs(numPixels * 3);
+  static GammaLUT gamma(2.2f);
+  OutputStage stage(ChannelOrder::RGB);
+  stage.setGamma(&gamma);
+  bench::run("OutputStage::writeFrame Pixel8", size, [&] {
+    stage.writeFrame(src.data(), size.rings, size.cols, gs.data());
+    bench::keep(gs.data());
+  });
+}
+
+static void benchFrameBuffer(const PovSize& size) {
+  std::vector<uint16_t> srcStorage(FrameBuffer::storageElems(size.rings, size.cols));
+  std::vector<uint16_t> dstStorage(FrameBuffer::storageElems(size.rings, size.cols));
+  FrameBuffer src(srcStorage.data(), size.rings, size.cols);
+  FrameBuffer dst(dstStorage.data(), size.rings, size.cols);
+  std::vector<Pixel> pix(size.rings * size.cols);
+  fillNoise(pix.data(), pix.size());
+  src.load(pix.data());
+
+  bench::run("vecFade(FrameBuffer)", size, [&] {
+    vecFade(src, dst, 3);
+    bench::keep(dst.plane(Channel::Blue));
+  });
+
+  bench::run("vecAdd(FrameBuffer)", size, [&] {
+    vecAdd(src, dst);
+    bench::keep(dst.plane(Channel::Blue));
+  });
+
+  bench::run("vecScale(FrameBuffer)", size, [&] {
+    vecScale(src, dst, toScale16(0.5f));
+    bench::keep(dst.plane(Channel::Blue));
+  });
+
+  bench::run("blur2d(FrameBuffer)", size, [&] {
+    blur2d(src, dst);
+    bench::keep(dst.plane(Channel::Blue));
+  });
+
+  bench::run("convolveSeparable(FB, Gauss5)", size, [&] {
+    convolveSeparable(src, dst, Gauss5, Gauss5, EdgeType::Reflect);
+    bench::keep(dst.plane(Channel::Blue));
+  });
+
+  bench::run("FrameBuffer::store", size, [&] {
+    src.store(pix.data());
+    bench::keep(pix.data());
+  });
+}
+
+static void benchOutput(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> frame(numPixels), tmp(numPixels);
+  std::vector<uint16_t> gs(numPixels * 3);
+  fillNoise(frame.data(), numPixels);
+  static GammaLUT gamma(2.2f);
+
+  // what it takes without the fused stage: scale, gamma, then reorder
+  bench::run("output: separate passes", size, [&] {
+    vecScale(frame.data(), tmp.data(), toScale16(128.0f), numPixels);
+    uint16_t* t = (uint16_t*)tmp.data();
+    for (uint32_t i = 0; i < numPixels * 3; i++)
+      t[i] = gamma.apply(t[i]);
+    for (uint32_t i = 0; i < numPixels; i++) {
+      gs[i * 3 + 0] = tmp[i].red;
+      gs[i * 3 + 1] = tmp[i].green;
+      gs[i * 3 + 2] = tmp[i].blue;
+    }
+    bench::keep(gs.data());
+  });
+
+  OutputStage stage(ChannelOrder::RGB);
+  stage.setBrightness(toScale16(128.0f));
+  stage.setGamma(&gamma);
+  bench::run("OutputStage::writeFrame", size, [&] {
+    stage.writeFrame(frame.data(), size.rings, size.cols, gs.data());
+    bench::keep(gs.data());
+  });
+
+  // Wire order the same as Pixel's storage order: no reordering at all
+  OutputStage native;
+  native.setBrightness(toScale16(128.0f));
+  native.setGamma(&gamma);
+  bench::run("OutputStage::writeFrame native", size, [&] {
+    native.writeFrame(frame.data(), size.rings, size.cols, gs.data());
+    bench::keep(gs.data());
+  });
+
+  // Rotating: re-render every column vs. reading through a view
+  bench::run("rotate by copy + writeFrame", size, [&] {
+    uint32_t shift = size.rings * 3; // 3 columns
+    std::copy(frame.begin() + shift, frame.end(), tmp.begin());
+    std::copy(frame.begin(), frame.begin() + shift, tmp.end() - shift);
+    stage.writeFrame(tmp.data(), size.rings, size.cols, gs.data());
+    bench::keep(gs.data());
+  });
+  RotatedView view(frame.data(), size.rings, size.cols);
+  view.setRotation(3 << 16);
+  bench::run("RotatedView writeFrame", size, [&] {
+    stage.writeFrame(view, gs.data());
+    bench::keep(gs.data());
+  });
+  view.setRotation((3 << 16) + 0x4000);
+  bench::run("RotatedView writeFrame frac", size, [&] {
+    stage.writeFrame(view, gs.data());
+    bench::keep(gs.data());
+  });
+
+  // Indexed: the fade and the color cycling only touch the palette
+  std::vector<uint8_t> indices(numPixels);
+  IndexedFrame indexed(indices.data(), size.rings, size.cols);
+  indexed.setColors(&rainbow12LUT[0], PaletteEntries);
+  for (uint32_t i = 0; i < numPixels; i++)
+    indices[i] = (uint8_t)(i * 7);
+  static GsPalette gsPalette;
+  bench::run("IndexedFrame fade+rotate+bake", size, [&] {
+    indexed.fade(1);
+    indexed.brighten(1);
+    indexed.rotatePalette(0, PaletteEntries, 1);
+    stage.bakePalette(indexed, gsPalette);
+    bench::keep(&gsPalette);
+  });
+  bench::run("OutputStage::writeFrame indexed", size, [&] {
+    stage.writeFrame(indexed, gsPalette, gs.data());
+    bench::keep(gs.data());
+  });
+}
+
+// Rainbow background with sparks on top
+static void benchCompositor(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> background(numPixels), sparks(numPixels), dst(numPixels);
+  fillNoise(background.data(), numPixels);
+  fillNoise(sparks.data(), numPixels);
+
+  bench::run("2 layers: copy + vecAdd", size, [&] {
+    vecFill(background.data(), dst.data(), numPixels);
+    vecAdd(sparks.data(), dst.data(), numPixels);
+    bench::keep(dst.data());
+  });
+
+  Compositor comp(size.rings, size.cols);
+  comp.addLayer(background.data());
+  int top = comp.addLayer(sparks.data(), BlendMode::Add);
+  bench::run("Compositor 2 layers (add)", size, [&] {
+    comp.compose(dst.data());
+    bench::keep(dst.data());
+  });
+  comp.setMode(top, BlendMode::Alpha);
+  comp.setAlpha(top, 96);
+  bench::run("Compositor 2 layers (alpha)", size, [&] {
+    comp.compose(dst.data());
+    bench::keep(dst.data());
+  });
+
+  // sparks only cover a few columns
+  ColumnBitmap covered;
+  for (uint32_t c = 0; c < size.cols; c += 16)
+    covered.set(c);
+  comp.setMode(top, BlendMode::Add);
+  comp.setCoverage(top, &covered);
+  bench::run("Compositor 2 layers (1/16 covered)", size, [&] {
+    comp.compose(dst.data());
+    bench::keep(dst.data());
+  });
+}
+
+static void benchRaster(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> pixels(numPixels);
+  PolarRaster raster(pixels.data(), size.rings, size.cols);
+  int32_t rings = toFixed16(size.rings);
+
+  // the old way: per-pixel loop testing every cell against the shape
+  bench::run("ring, per-pixel loop", size, [&] {
+    for (uint32_t i = 0; i < size.cols; i++)
+      for (uint32_t j = 0; j < size.rings; j++)
+        if (j >= size.rings / 2 && j < size.rings / 2 + 2)
+          pixels[indexAt(size.rings, i, j)] = Colors::Red;
+    bench::keep(pixels.data());
+  });
+  bench::run("PolarRaster::ring (2 rings)", size, [&] {
+    raster.ring(rings / 2, rings / 2 + toFixed16(2), Colors::Red);
+    bench::keep(pixels.data());
+  });
+  bench::run("PolarRaster::sector (1/8)", size, [&] {
+    raster.sector(0, toFixed16(size.cols / 8), Colors::Red);
+    bench::keep(pixels.data());
+  });
+  raster.setAntialias(true);
+  bench::run("PolarRaster::ring AA", size, [&] {
+    raster.ring(rings / 2 + 0x4000, rings / 2 + toFixed16(2.5f), Colors::Red);
+    bench::keep(pixels.data());
+  });
+  bench::run("PolarRaster::spiral AA", size, [&] {
+    raster.spiral(0, rings / 4, toFixed16(1.5f), 0x8000, Colors::Blue);
+    bench::keep(pixels.data());
+  });
+}
+
+static void benchPolarMap(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  uint32_t side = 2 * size.rings; // image just covering the disc
+  std::vector<Pixel> image(side * side), polar(numPixels);
+  std::vector<PolarTap> taps(numPixels), xyTaps(side * side);
+  fillNoise(image.data(), side * side);
+
+  PolarMap map(taps.data(), size.rings, size.cols);
+  map.build(side, side, Sampling::Nearest);
+  bench::run("PolarMap::blit nearest", size, [&] {
+    map.blit(image.data(), polar.data());
+    bench::keep(polar.data());
+  });
+  map.build(side, side, Sampling::Bilinear);
+  bench::run("PolarMap::blit bilinear", size, [&] {
+    map.blit(image.data(), polar.data());
+    bench::keep(polar.data());
+  });
+
+  CartesianMap preview(xyTaps.data(), side, side);
+  preview.build(size.rings, size.cols);
+  bench::run("CartesianMap::blit bilinear", size, [&] {
+    preview.blit(polar.data(), image.data());
+    bench::keep(image.data());
+  });
+}
+
+static void benchOscillators() {
+  static OscillatorBank<1024> bank;
+  static uint16_t wave[1024];
+  bank.spread(2.0f);
+  PovSize perCol = { 1, 1024 }; // e.g. one oscillator per column
+  bench::run("OscillatorBank advance+sine", perCol, [&] {
+    bank.advance(1000);
+    bank.sine(wave);
+    bench::keep(wave);
+  });
+}
+
+// A full pool, respawned whenever it runs low; ns per particle for update and splat
+static void benchParticles() {
+  static ParticlePool<1024> pool(32, 256);
+  static Pixel pixels[32 * 256];
+  pool.setGravity(toFixed16(4.0f));
+  PovSize perParticle = { 1, pool.capacity() };
+  auto refill = [&] {
+    while (!pool.full())
+      pool.burst(toFixed16(rand() % 256), toFixed16(16.0f), 32, toFixed16(12.0f), Colors::Orange, 2000);
+  };
+  refill();
+  bench::run("ParticlePool::update (1024)", perParticle, [&] {
+    pool.update(1000);
+    refill();
+    bench::keep(pool.col);
+  });
+  bench::run("ParticlePool::splat (1024)", perParticle, [&] {
+    pool.splat(pixels);
+    bench::keep(pixels);
+  });
+}
+
+// A full queue of alternating edges pushed then drained; ns per event, queue overhead only
+static void benchInput() {
+  struct KeyCounter {
+    uint32_t presses = 0;
+    void processKeypress(uint16_t keys, uint16_t diff) { presses += (keys & diff) != 0; }
+  } counter;
+  static KeyEventQueue<32> queue;
+  InputLatency latency(1000);
+  PovSize perEvent = { 1, queue.capacity() };
+  uint32_t now = 0;
+  bench::run("KeyEventQueue push+drain (32)", perEvent, [&] {
+    for (uint32_t i = 0; i < 32; i++)
+      queue.push((uint16_t)(now + i) & 1, now + i);
+    queue.drain(counter, &latency);
+    latency.presented(now += 32);
+    bench::keep(&counter.presses);
+  });
+}
+
+static void benchDemos(const PovSize& size) {
+  uint32_t numPixels = size.rings * size.cols;
+  std::vector<Pixel> pixels(numPixels);
+
+  SimpleFlash flash(Colors::Red, 0, 0.5f); // 0us delay: redraw on every tick
+  flash.setup(pixels.data(), size.rings, size.cols);
+  bench::run("SimpleFlash::tick", size, [&] {
+    flash.tick();
+    bench::keep(pixels.data());
+  });
+
+  RainbowWheel wheel(0.5f);
+  bench::run("RainbowWheel::setup", size, [&] {
+    wheel.setup(pixels.data(), size.rings, size.cols);
+    bench::keep(pixels.data());
+  });
+  bench::run("RainbowWheel::renderColumns (all)", size, [&] {
+    wheel.renderColumns(0, size.cols);
+    bench::keep(pixels.data());
+  });
+
+  // Race the beam: only the 8 columns ahead of the sweep changed
+  ColumnScheduler sched(size.cols);
+  bench::run("RainbowWheel 8 cols (scheduler)", size, [&] {
+    sched.markDirty(0, 8);
+    sched.service(wheel);
+    bench::keep(pixels.data());
+  });
+
+  sched.resetStats();
+  bench::run("SimpleFlash all cols (scheduler)", size, [&] {
+    sched.service(flash);
+    bench::keep(pixels.data());
+  });
+
+  // Two still wheels, so only the blend is measured. The transition is long enough to
+  // stay near its start, wipe/iris are then mostly copies
+  std::vector<Pixel> scratch(2 * numPixels);
+  PixelArena arena(scratch.data(), scratch.size());
+  Transition fader(arena);
+  RainbowWheel wheelA(0.5f), wheelB(0.25f);
+  const char* names[] = { "Transition fade tick", "Transition wipe tick", "Transition iris tick" };
+  TransitionType types[] = { TransitionType::Fade, TransitionType::Wipe, TransitionType::Iris };
+  wheelA.setup(pixels.data(), size.rings, size.cols);
+  for (uint32_t i = 0; i < 3; i++) {
+    fader.start(wheelA, wheelB, pixels.data(), size.rings, size.cols, types[i], 3600000000u);
+    bench::run(names[i], size, [&] {
+      fader.tick();
+      bench::keep(pixels.data());
+    });
+  }
+
+  // switching is a destroy + construct in the same slot, then the new demo's setup
+  static DemoRegistry<SimpleFlash, RainbowWheel, RingDemo, Fireworks> demos;
+  uint32_t which = 0;
+  bench::run("DemoRegistry switch + setup", size, [&] {
+    if (which++ & 1)
+      demos.emplace<RainbowWheel>(0.5f);
+    else
+      demos.emplace<SimpleFlash>(Colors::Red, 0, 0.5f);
+    demos.setup(pixels.data(), size.rings, size.cols);
+    bench::keep(pixels.data());
+  });
+
+  RingDemo ring(0.5f, 10000);
+  ring.setup(pixels.data(), size.rings, size.cols);
+  bench::run("RingDemo::tick", size, [&] {
+    ring.tick();
+    bench::keep(pixels.data());
+  });
+
+  // Playback of recorded fireworks, looping over keyframes and deltas alike
+  AnimationEncoder enc(size.rings, size.cols, 10000, 16);
+  Fireworks fireworks(0.5f);
+  recordDemo(fireworks, enc, 64, 8);
+  std::vector<uint8_t> anim = enc.encode();
+  AnimationDecoder decoder;
+  decoder.open(anim.data(), (uint32_t)anim.size());
+  bench::run("AnimationDecoder::decodeFrame", size, [&] {
+    decoder.decodeFrame(pixels.data());
+    bench::keep(pixels.data());
+  });
+}
+
+int main(int argc, char** argv) {
+  bench::parseArgs(argc, argv);
+  bench::header();
+  for (const PovSize& size : povSizes) {
+    benchKernels(size);
+    benchPixel8(size);
+    benchFrameBuffer(size);
+    benchOutput(size);
+    benchCompositor(size);
+    benchRaster(size);
+    benchPolarMap(size);
+    benchDemos(size);
+  }
+  benchOscillators();
+  benchParticles();
+  benchInput();
+#ifdef TGRAPHICS_PROFILE
+  profiler.dump();
+#endif
+  return 0;
+}
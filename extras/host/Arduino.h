@@ -0,0 +1,92 @@
+#ifndef __HOST_ARDUINO_H
+#define __HOST_ARDUINO_H
+// Host stand-in for the parts of <Arduino.h> that tgraphics uses.
+// Only used by the CMake host build (see CMakeLists.txt), never on the Teensy.
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Tools that record demos step time by hand (manual = true, then set now) so the
+// output doesn't depend on how fast the host runs
+struct HostClock {
+  bool manual = false;
+  uint32_t now = 0;
+};
+inline HostClock hostClock;
+
+// Same wrap-around behaviour as the Teensy core: 32-bit microseconds since start
+inline uint32_t micros() {
+  if (hostClock.manual)
+    return hostClock.now;
+  static const auto start = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+inline uint32_t millis() {
+  return micros() / 1000;
+}
+
+// Writes what Serial would send to a FILE* (stdout by default)
+class HostSerial {
+  public:
+    FILE* out = stdout;
+
+    void begin(uint32_t) {}
+    size_t write(uint8_t b) { return fputc(b, out) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buf, size_t len) { return fwrite(buf, 1, len, out); }
+    int availableForWrite() { return 64; }
+    void flush() { fflush(out); }
+
+    void print(const char* s) { fputs(s, out); }
+    void print(char c) { fputc(c, out); }
+    void print(double d, int digits = 2) { fprintf(out, "%.*f", digits, d); }
+    void print(unsigned long n, int base = DEC) { printNumber(n, base); }
+    void print(unsigned int n, int base = DEC) { printNumber(n, base); }
+    void print(unsigned short n, int base = DEC) { printNumber(n, base); }
+    void print(unsigned char n, int base = DEC) { printNumber(n, base); }
+    void print(long n, int base = DEC) {
+      if (n < 0 && base == DEC) {
+        fputc('-', out);
+        printNumber(-(unsigned long)n, base);
+      } else {
+        printNumber((unsigned long)n, base);
+      }
+    }
+    void print(int n, int base = DEC) { print((long)n, base); }
+    void print(short n, int base = DEC) { print((long)n, base); }
+
+    void println() { fputs("\r\n", out); }
+    template <typename T>
+    void println(T v) { print(v); println(); }
+    template <typename T>
+    void println(T v, int base) { print(v, base); println(); }
+
+    explicit operator bool() { return true; }
+
+  private:
+    void printNumber(unsigned long n, int base) {
+      char buf[8 * sizeof(unsigned long) + 1];
+      char* p = &buf[sizeof(buf) - 1];
+      *p = '\0';
+      if (base < 2) base = DEC;
+      do {
+        unsigned long digit = n % base;
+        *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+        n /= base;
+      } while (n);
+      fputs(p, out);
+    }
+};
+
+inline HostSerial Serial;
+
+#endif // ifndef __HOST_ARDUINO_H
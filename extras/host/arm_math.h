@@ -0,0 +1,34 @@
+#ifndef __HOST_ARM_MATH_H
+#define __HOST_ARM_MATH_H
+// Host stand-in for the CMSIS-DSP pieces tgraphics uses.
+// Reference (scalar) implementations, only used by the CMake host build.
+#include <cstdint>
+
+typedef int16_t q15_t;
+
+typedef enum {
+  ARM_MATH_SUCCESS = 0,
+  ARM_MATH_ARGUMENT_ERROR = -1,
+  ARM_MATH_SIZE_MISMATCH = -3,
+} arm_status;
+
+typedef struct {
+  uint16_t numRows;
+  uint16_t numCols;
+  q15_t* pData;
+} arm_matrix_instance_q15;
+
+inline arm_status arm_mat_trans_q15(const arm_matrix_instance_q15* pSrc,
+                                    arm_matrix_instance_q15* pDst) {
+  if (pSrc->numRows != pDst->numCols || pSrc->numCols != pDst->numRows)
+    return ARM_MATH_SIZE_MISMATCH;
+
+  for (uint16_t row = 0; row < pSrc->numRows; row++) {
+    for (uint16_t col = 0; col < pSrc->numCols; col++) {
+      pDst->pData[col * pDst->numCols + row] = pSrc->pData[row * pSrc->numCols + col];
+    }
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+#endif // ifndef __HOST_ARM_MATH_H
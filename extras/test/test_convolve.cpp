@@ -0,0 +1,95 @@
+// Host test for convolveSeparable edge cases: kernels that overflow a 32-bit
+// accumulator and kernels too large to run, which must pass the image through.
+#include "tgraphics.h"
+
+#include <cstdio>
+
+static int failures = 0;
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                \
+    }                                                            \
+  } while (0)
+
+const uint32_t SizeX = 24, SizeY = 16, Elems = SizeX * SizeY * 3;
+
+template <typename T>
+static bool allEqual(const T* img, uint32_t count, T value) {
+  for (uint32_t i = 0; i < count; i++)
+    if (img[i] != value)
+      return false;
+  return true;
+}
+
+// Taps summing to 1.5 on full scale data: saturates to full scale, never wraps to black
+template <typename T>
+static void testBrighteningKernel(const int16_t* taps, uint32_t size, T value, T expected) {
+  static T src[Elems], dst[Elems];
+  for (uint32_t i = 0; i < Elems; i++)
+    src[i] = value;
+  ImageLayout layout = { SizeX, SizeY, SizeX * 3, 3 };
+  Kernel15 kernel = { taps, size };
+  convolveSeparable(src, dst, layout, kernel, kernel, Cylindrical);
+  CHECK(allEqual(dst, Elems, expected));
+}
+
+static void testWideKernels() {
+  const int16_t bright3[] = { 16384, 16384, 16384 };
+  const int16_t bright5[] = { 16384, 16384, 16384, 16384, 16384 };
+  const int16_t dark3[] = { -32768, -32768, -32768 };
+  const int16_t bright15[] = { 8192, 8192, 8192, 8192, 8192, 8192, 8192, 8192,
+                               8192, 8192, 8192, 8192, 8192, 8192, 8192 };
+  testBrighteningKernel<uint16_t>(bright3, 3, 0xffff, 0xffff);
+  testBrighteningKernel<uint16_t>(bright5, 5, 0xffff, 0xffff);
+  testBrighteningKernel<uint16_t>(bright15, 15, 0xffff, 0xffff);
+  testBrighteningKernel<uint16_t>(dark3, 3, 0xffff, 0);
+  testBrighteningKernel<uint8_t>(bright15, 15, 0xff, 0xff);
+  // Still exact below saturation, both passes scale by 1.5
+  testBrighteningKernel<uint16_t>(bright3, 3, 0x2000, 0x4800);
+
+  // The float wrapper clamps each tap but keeps the sum
+  static uint16_t src[Elems], dst[Elems];
+  for (uint32_t i = 0; i < Elems; i++)
+    src[i] = 0xffff;
+  float halves[] = { 0.5f, 0.5f, 0.5f };
+  convolveSeparable(src, SizeX, SizeY, halves, 3, halves, 3, EdgeType::Wrap, dst);
+  CHECK(allEqual(dst, Elems, (uint16_t)0xffff));
+}
+
+static void testOversizedKernel() {
+  static uint16_t src[Elems], dst[Elems];
+  for (uint32_t i = 0; i < Elems; i++) {
+    src[i] = (uint16_t)(i * 2654435761u >> 16);
+    dst[i] = 0x1234;
+  }
+  float box[17], one[] = { 1.0f };
+  for (uint32_t k = 0; k < 17; k++)
+    box[k] = 1.0f / 17;
+  convolveSeparable(src, SizeX, SizeY, box, 17, one, 1, EdgeType::Wrap, dst);
+  bool same = true;
+  for (uint32_t i = 0; i < Elems; i++)
+    same = same && dst[i] == src[i];
+  CHECK(same);
+
+  for (uint32_t i = 0; i < Elems; i++)
+    dst[i] = 0x1234;
+  convolveSeparable(src, SizeX, SizeY, one, 1, box, 17, EdgeType::Wrap, dst);
+  same = true;
+  for (uint32_t i = 0; i < Elems; i++)
+    same = same && dst[i] == src[i];
+  CHECK(same);
+}
+
+int main() {
+  testWideKernels();
+  testOversizedKernel();
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all convolve checks passed\n");
+  return 0;
+}
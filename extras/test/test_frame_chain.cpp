@@ -0,0 +1,152 @@
+// Host test for FrameChain: a render thread publishes numbered frames while a
+// simulated display thread consumes them at a fixed rate, like the display ISR would.
+#include "frame_chain.h"
+#include "animation_demos.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+typedef PixelFrame<16, 64> TestFrame;
+
+static int failures = 0;
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                \
+    }                                                            \
+  } while (0)
+
+static void drawFrame(TestFrame& frame, uint16_t frameNumber) {
+  for (uint32_t i = 0; i < TestFrame::rings * TestFrame::cols; i++)
+    frame.pixels[i] = { frameNumber, frameNumber, frameNumber };
+}
+
+// Returns the frame number if every pixel agrees, -1 if the frame tore
+static int32_t frameNumberOf(const TestFrame& frame) {
+  uint16_t n = frame.pixels[0].blue;
+  for (uint32_t i = 0; i < TestFrame::rings * TestFrame::cols; i++) {
+    const Pixel& p = frame.pixels[i];
+    if (p.blue != n || p.green != n || p.red != n)
+      return -1;
+  }
+  return n;
+}
+
+template <uint8_t Count>
+static void runChain(const char* name, uint32_t renderUs, uint32_t displayUs, uint32_t revolutions) {
+  static FrameChain<TestFrame, Count> chain;
+  chain.reset();
+  for (uint8_t i = 0; i < Count; i++)
+    drawFrame(chain.buffer(i), 0);
+
+  std::atomic<bool> done(false);
+  uint32_t rendered = 0;
+
+  std::thread render([&] {
+    uint16_t frameNumber = 1;
+    while (!done.load()) {
+      if (!chain.canRender())
+        continue;
+      drawFrame(chain.back(), frameNumber++);
+      std::this_thread::sleep_for(std::chrono::microseconds(renderUs));
+      chain.publish();
+      rendered++;
+    }
+  });
+
+  uint32_t torn = 0, backwards = 0, unique = 0, repeats = 0;
+  int32_t last = 0;
+  auto next = std::chrono::steady_clock::now();
+  for (uint32_t rev = 0; rev < revolutions; rev++) {
+    next += std::chrono::microseconds(displayUs);
+    std::this_thread::sleep_until(next);
+    const TestFrame& frame = chain.acquire();
+    int32_t n = frameNumberOf(frame);
+    // simulate the display scanning the frame out while the renderer keeps going
+    std::this_thread::sleep_for(std::chrono::microseconds(displayUs / 4));
+    if (frameNumberOf(frame) != n)
+      torn++;
+    if (n < 0)
+      torn++;
+    else if (n < last)
+      backwards++;
+    else if (n == last)
+      repeats++;
+    else
+      unique++;
+    last = n;
+  }
+  done.store(true);
+  render.join();
+
+  printf("%-24s rendered %5u published %5u displayed %5u unique %5u dropped %5u late %5u\n",
+         name, rendered, chain.published(), chain.displayed(), unique, chain.dropped(), chain.late());
+
+  CHECK(torn == 0);
+  CHECK(backwards == 0);
+  CHECK(chain.displayed() == revolutions);
+  CHECK(chain.published() == rendered);
+  CHECK(chain.late() == repeats);
+  // every published frame was either shown, dropped, or is still waiting to be shown
+  uint32_t accounted = unique + chain.dropped();
+  CHECK(accounted == chain.published() || accounted + 1 == chain.published());
+}
+
+// RingDemo only erases and redraws its ring, so it relies on back() holding the last frame.
+// Drawn through the chain it has to match the same demo drawing into a single buffer.
+template <uint8_t Count>
+static uint32_t runIncrementalDemo(bool copyForward, uint32_t frames) {
+  static FrameChain<TestFrame, Count> chain;
+  static TestFrame reference;
+  chain.reset();
+  chain.setCopyForward(copyForward);
+  for (uint8_t i = 0; i < Count; i++)
+    drawFrame(chain.buffer(i), 0);
+
+  hostClock.manual = true;
+  hostClock.now = 0;
+  RingDemo direct(1.0f, 10000), chained(1.0f, 10000);
+  direct.setup(reference.pixels, TestFrame::rings, TestFrame::cols);
+  chained.setup(chain.back().pixels, TestFrame::rings, TestFrame::cols);
+  chain.publish();
+  chain.acquire();
+
+  uint32_t mismatches = 0;
+  for (uint32_t f = 0; f < frames; f++) {
+    hostClock.now += 100000; // big steps, so the ring jumps further than it erases
+    direct.tick();
+    CHECK(chain.canRender());
+    chained.setBuffer(chain.back().pixels);
+    chained.tick();
+    chain.publish();
+    if (memcmp(chain.acquire().pixels, reference.pixels, sizeof(reference.pixels)) != 0)
+      mismatches++;
+  }
+  hostClock.manual = false;
+  return mismatches;
+}
+
+int main() {
+  CHECK(runIncrementalDemo<3>(true, 200) == 0);
+  CHECK(runIncrementalDemo<2>(true, 200) == 0);
+  // without copy-forward the ring leaves stale copies behind in the older buffers
+  CHECK(runIncrementalDemo<3>(false, 200) > 0);
+
+  // renderer faster than the display: triple buffering drops, never late once warm
+  runChain<3>("triple, fast render", 50, 1000, 100);
+  // renderer slower than the display: the display repeats frames
+  runChain<3>("triple, slow render", 2500, 1000, 100);
+  runChain<2>("double, fast render", 50, 1000, 100);
+  runChain<2>("double, slow render", 2500, 1000, 100);
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all FrameChain checks passed\n");
+  return 0;
+}
@@ -0,0 +1,212 @@
+// Host test for FrameDump: the serial port is swapped for a file or a pipe, and what
+// comes out is read back with the same decoder tgraphics_undump uses.
+#include "frame_dump.h"
+#include "animation_demos.h"
+#include "../tools/dump_decoder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static int failures = 0;
+
+#define CHECK(cond)                                              \
+  do {                                                           \
+    if (!(cond)) {                                               \
+      printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                \
+    }                                                            \
+  } while (0)
+
+// Stands in for Serial: a TX buffer with room bytes free, refilled by the test as if
+// the bytes had gone out on the wire
+struct FilePort {
+  int fd;
+  int room;
+  int availableForWrite() { return room; }
+  size_t write(const uint8_t* buf, size_t len) {
+    if ((int)len > room || ::write(fd, buf, len) != (ssize_t)len)
+      return 0;
+    room -= (int)len;
+    return len;
+  }
+};
+
+const uint32_t Rings = 16;
+const uint32_t Cols = 64;
+
+static std::vector<uint8_t> readAll(FILE* f) {
+  std::vector<uint8_t> bytes;
+  fflush(f);
+  rewind(f);
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+    bytes.insert(bytes.end(), buf, buf + n);
+  return bytes;
+}
+
+// Checks the raw bytes against the documented layout (Rgb8 red first, Pixel16 blue first,
+// little endian) as well as what DumpFrame::channel() makes of them
+static bool samePixels(const DumpFrame& f, const Pixel* pixels, DumpFormat format) {
+  for (uint32_t col = 0; col < Cols; col++) {
+    for (uint32_t ring = 0; ring < Rings; ring++) {
+      uint32_t i = indexAt(Rings, col, ring);
+      const Pixel& p = pixels[i];
+      uint32_t want[3] = { p.blue, p.green, p.red };
+      const uint8_t* raw = &f.pixels[i * f.unitBytes()];
+      for (uint32_t c = 0; c < 3; c++) {
+        uint32_t v = format == DumpFormat::Rgb8 && want[c] > 0xff ? 0xff : want[c];
+        uint32_t stored = format == DumpFormat::Rgb8 ? raw[2 - c] : raw[2 * c] | raw[2 * c + 1] << 8;
+        if (stored != v || f.channel(col, ring, c) != v)
+          return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Dumps frames of a running demo through a file, every one must come back exactly
+static void testRoundTrip(const char* name, DumpFormat format, bool delta) {
+  static Pixel pixels[Rings * Cols];
+  static uint8_t snap[FrameDump::bytesFor(Rings, Cols, DumpFormat::Pixel16)];
+  static uint8_t ref[sizeof(snap)];
+  static Pixel sent[20][Rings * Cols];
+  FrameDump dump(snap, ref, sizeof(snap));
+  dump.setDelta(delta, 8);
+
+  FILE* file = tmpfile();
+  FilePort port = { fileno(file), 64 };
+  Fireworks demo(0.5f, 400);
+  hostClock.manual = true;
+  hostClock.now = 0;
+  demo.setup(pixels, Rings, Cols);
+  for (uint32_t f = 0; f < 20; f++) {
+    hostClock.now += 20000;
+    if (f % 5 == 0)
+      demo.processKeypress(1 << (f / 5), 1 << (f / 5));
+    demo.tick();
+    pixels[0] = { 0x1ff, 0, 0x100 }; // over 8 bits, saturates in Rgb8
+    pixels[1] = { 0x10, 0x20, 0x30 }; // blue, green, red
+    memcpy(sent[f], pixels, sizeof(pixels));
+    CHECK(dump.capture(pixels, Rings, Cols, format, f));
+    while (dump.busy()) {
+      port.room = 64;
+      CHECK(dump.service(port) <= 64);
+    }
+  }
+  hostClock.manual = false;
+  CHECK(dump.dumps() == 20);
+
+  std::vector<uint8_t> stream = readAll(file);
+  fclose(file);
+  DumpDecoder decoder;
+  uint32_t frames = 0, deltas = 0;
+  decoder.feed(stream.data(), stream.size(), [&](const DumpFrame& f) {
+    CHECK(f.frame == frames);
+    CHECK(f.rings == Rings && f.cols == Cols && f.format == format);
+    CHECK(f.timeUs == 20000 * (frames + 1));
+    CHECK(samePixels(f, sent[frames], format));
+    if (format == DumpFormat::Rgb8)
+      CHECK(f.pixels[3] == 0x30 && f.pixels[4] == 0x20 && f.pixels[5] == 0x10);
+    else
+      CHECK(f.pixels[6] == 0x10 && f.pixels[8] == 0x20 && f.pixels[10] == 0x30);
+    deltas += f.delta;
+    frames++;
+  });
+  CHECK(frames == 20);
+  CHECK(decoder.bad() == 0);
+  // keyframe every 8th dump: 0, 8 and 16 go whole
+  CHECK(deltas == (delta ? 17u : 0u));
+  uint32_t full = 20 * (DumpHeaderSize + FrameDump::bytesFor(Rings, Cols, format));
+  printf("%-22s %6zu bytes for 20 frames (%u sent whole)\n", name, stream.size(), full);
+  if (delta)
+    CHECK(stream.size() < full / 2);
+}
+
+static void testBusyAndBackpressure() {
+  static Pixel pixels[Rings * Cols];
+  static uint8_t snap[FrameDump::bytesFor(Rings, Cols, DumpFormat::Pixel16)];
+  FrameDump dump(snap, nullptr, sizeof(snap));
+  FILE* file = tmpfile();
+  FilePort port = { fileno(file), 0 };
+
+  CHECK(dump.capture(pixels, Rings, Cols, DumpFormat::Pixel16, 1));
+  CHECK(!dump.capture(pixels, Rings, Cols, DumpFormat::Pixel16, 2)); // still going out
+  CHECK(dump.dropped() == 1);
+  CHECK(dump.service(port) == 0); // port full, nothing waits for it
+  CHECK(dump.busy());
+  CHECK(!dump.capture(pixels, 64, 64, DumpFormat::Pixel16, 3)); // doesn't fit the buffer
+  port.room = 1;
+  CHECK(dump.service(port) == 1);
+  CHECK(dump.service(port) == 0);
+  while (dump.busy()) {
+    port.room = 4096;
+    dump.service(port);
+  }
+  CHECK(dump.dumps() == 1);
+  fclose(file);
+}
+
+// GS buffer dump through a pipe, with a reader on the other end joining mid-packet
+static void testGsThroughPipe() {
+  static uint16_t gs[Rings * Cols * 3];
+  static uint8_t snap[FrameDump::bytesFor(Rings, Cols, DumpFormat::Gs16)];
+  for (uint32_t i = 0; i < Rings * Cols * 3; i++)
+    gs[i] = (uint16_t)(i * 37);
+  FrameDump dump(snap, nullptr, sizeof(snap));
+  int fds[2];
+  CHECK(pipe(fds) == 0);
+
+  // only read once the reader is joined, CHECK isn't safe to call from its thread
+  uint32_t frames = 0, bad = 0;
+  bool match = true;
+  std::thread reader([&] {
+    DumpDecoder decoder;
+    uint8_t buf[512];
+    ssize_t n;
+    bool first = true;
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+      uint32_t from = first ? 7 : 0; // drop the start, as if we opened the port late
+      first = false;
+      decoder.feed(buf + from, n - from, [&](const DumpFrame& f) {
+        for (uint32_t i = 0; i < Rings * Cols * 3; i++)
+          match &= (f.pixels[2 * i] | f.pixels[2 * i + 1] << 8) == gs[i];
+        frames++;
+      });
+    }
+    bad = decoder.bad();
+  });
+
+  FilePort port = { fds[1], 256 };
+  for (uint32_t f = 0; f < 5; f++) {
+    CHECK(dump.captureGs(gs, Rings, Cols, f));
+    while (dump.busy()) {
+      port.room = 256;
+      dump.service(port);
+    }
+  }
+  close(fds[1]);
+  reader.join();
+  close(fds[0]);
+  CHECK(bad == 0);
+  CHECK(frames == 4); // the first one was cut off
+  CHECK(match);
+}
+
+int main() {
+  testRoundTrip("pixel16 full", DumpFormat::Pixel16, false);
+  testRoundTrip("pixel16 delta", DumpFormat::Pixel16, true);
+  testRoundTrip("rgb8 delta", DumpFormat::Rgb8, true);
+  testBusyAndBackpressure();
+  testGsThroughPipe();
+
+  if (failures) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  printf("all FrameDump checks passed\n");
+  return 0;
+}
@@ -0,0 +1,278 @@
+#ifndef __ANIMATION_ENCODER_H
+#define __ANIMATION_ENCODER_H
+// Host side encoder for animation_stream.h containers, used by tgraphics_encode.
+// Uses the standard library freely, it's never built for the Teensy.
+#include "animation_stream.h"
+#include "animation_demos.h"
+#include "rotation_view.h"
+#include <Arduino.h> // hostClock
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// Collects frames, then quantizes them to one palette (median cut, exact when there
+// are 256 colors or fewer) and codes every column against the frame before it
+class AnimationEncoder {
+  public:
+    // The header stores the keyframe interval in 16 bits, it's clamped to 1 - 0xffff
+    AnimationEncoder(uint32_t rings, uint32_t cols, uint32_t frameUs, uint32_t keyframeInterval = 32)
+      : numRings(rings), numCols(cols), usPerFrame(frameUs),
+        keyInterval(keyframeInterval == 0 ? 1 : keyframeInterval > 0xffff ? 0xffff : keyframeInterval),
+        worstError(0) {}
+
+    void addFrame(const Pixel* pixels) {
+      frameData.insert(frameData.end(), pixels, pixels + numRings * numCols);
+    }
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    uint32_t frames() const { return (uint32_t)(frameData.size() / (numRings * numCols)); }
+    uint32_t frameUs() const { return usPerFrame; }
+
+    std::vector<uint8_t> encode() {
+      buildPalette();
+      uint32_t numFrames = frames();
+      uint32_t frameSize = numRings * numCols;
+      uint32_t numKeys = (numFrames + keyInterval - 1) / keyInterval;
+
+      std::vector<uint8_t> out(AnimationHeaderSize);
+      memcpy(out.data(), "TGAN", 4);
+      out[4] = AnimationVersion;
+      out[5] = 0;
+      put16(out, 6, numRings);
+      put16(out, 8, numCols);
+      put16(out, 10, numFrames);
+      put16(out, 12, keyInterval);
+      put16(out, 14, (uint32_t)palette.size());
+      put32(out, 16, usPerFrame);
+      for (const Pixel& c : palette) {
+        size_t at = out.size();
+        out.resize(at + PaletteColorBytes);
+        put16(out, at, c.blue);
+        put16(out, at + 2, c.green);
+        put16(out, at + 4, c.red);
+      }
+      size_t keyTable = out.size();
+      out.resize(out.size() + 4 * numKeys);
+
+      for (uint32_t f = 0; f < numFrames; f++) {
+        bool key = f % keyInterval == 0;
+        if (key)
+          put32(out, keyTable + 4 * (f / keyInterval), (uint32_t)out.size());
+        const uint8_t* cur = &indices[(size_t)f * frameSize];
+        const uint8_t* prev = key ? nullptr : cur - frameSize;
+        encodeFrame(out, cur, prev);
+      }
+      return out;
+    }
+
+    // After encode(): the palette, the largest channel error it introduced, and every
+    // frame as it should decode
+    const std::vector<Pixel>& colors() const { return palette; }
+    uint32_t maxError() const { return worstError; }
+    Pixel decoded(uint32_t frame, uint32_t i) const {
+      return palette[indices[(size_t)frame * numRings * numCols + i]];
+    }
+
+  private:
+    struct Entry {
+      uint64_t key;
+      uint32_t count;
+    };
+
+    static uint64_t keyOf(const Pixel& p) {
+      return p.blue | (uint64_t)p.green << 16 | (uint64_t)p.red << 32;
+    }
+    static uint32_t channel(uint64_t key, uint32_t c) {
+      return (uint32_t)(key >> (16 * c)) & 0xffff;
+    }
+    static void put16(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+      out[at] = (uint8_t)v;
+      out[at + 1] = (uint8_t)(v >> 8);
+    }
+    static void put32(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+      put16(out, at, v & 0xffff);
+      put16(out, at + 2, v >> 16);
+    }
+
+    // Median cut: keep splitting the box with the widest channel at its weighted median
+    // until there are 256 boxes, each box becomes its (weighted) mean color
+    void buildPalette() {
+      std::unordered_map<uint64_t, uint32_t> histogram;
+      for (const Pixel& p : frameData)
+        histogram[keyOf(p)]++;
+      std::vector<Entry> entries;
+      for (const auto& h : histogram)
+        entries.push_back({ h.first, h.second });
+      std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+      struct Box {
+        uint32_t first, last; // [first, last) of entries
+        uint32_t channel;     // the widest one, and its range
+        uint32_t range;
+      };
+      auto makeBox = [&](uint32_t first, uint32_t last) {
+        Box b = { first, last, 0, 0 };
+        for (uint32_t c = 0; c < 3; c++) {
+          uint32_t lo = 0xffff, hi = 0;
+          for (uint32_t i = first; i < last; i++) {
+            lo = std::min(lo, channel(entries[i].key, c));
+            hi = std::max(hi, channel(entries[i].key, c));
+          }
+          if (hi >= lo && hi - lo > b.range) {
+            b.range = hi - lo;
+            b.channel = c;
+          }
+        }
+        return b;
+      };
+      std::vector<Box> boxes = { makeBox(0, (uint32_t)entries.size()) };
+      while (boxes.size() < 256) {
+        uint32_t split = 0;
+        for (uint32_t b = 1; b < boxes.size(); b++) {
+          if (boxes[b].range > boxes[split].range)
+            split = b;
+        }
+        if (boxes[split].range == 0)
+          break; // every box is a single color
+        Box b = boxes[split];
+        uint32_t c = b.channel;
+        std::sort(entries.begin() + b.first, entries.begin() + b.last,
+                  [c](const Entry& x, const Entry& y) { return channel(x.key, c) < channel(y.key, c); });
+        uint64_t total = 0;
+        for (uint32_t i = b.first; i < b.last; i++)
+          total += entries[i].count;
+        // weighted median, both halves get at least one color
+        uint32_t mid = b.first + 1;
+        uint64_t seen = entries[b.first].count;
+        while (mid < b.last - 1 && seen * 2 < total)
+          seen += entries[mid++].count;
+        boxes[split] = makeBox(b.first, mid);
+        boxes.push_back(makeBox(mid, b.last));
+      }
+
+      palette.clear();
+      std::unordered_map<uint64_t, uint8_t> indexOf;
+      worstError = 0;
+      for (const Box& b : boxes) {
+        uint64_t sum[3] = { 0, 0, 0 }, total = 0;
+        for (uint32_t i = b.first; i < b.last; i++) {
+          for (uint32_t c = 0; c < 3; c++)
+            sum[c] += (uint64_t)channel(entries[i].key, c) * entries[i].count;
+          total += entries[i].count;
+        }
+        Pixel mean = { 0, 0, 0 };
+        if (total)
+          mean = { (uint16_t)((sum[0] + total / 2) / total), (uint16_t)((sum[1] + total / 2) / total),
+                   (uint16_t)((sum[2] + total / 2) / total) };
+        for (uint32_t i = b.first; i < b.last; i++) {
+          indexOf[entries[i].key] = (uint8_t)palette.size();
+          for (uint32_t c = 0; c < 3; c++) {
+            uint32_t m = channel(keyOf(mean), c), v = channel(entries[i].key, c);
+            worstError = std::max(worstError, m > v ? m - v : v - m);
+          }
+        }
+        palette.push_back(mean);
+      }
+      indices.resize(frameData.size());
+      for (size_t i = 0; i < frameData.size(); i++)
+        indices[i] = indexOf[keyOf(frameData[i])];
+    }
+
+    void encodeFrame(std::vector<uint8_t>& out, const uint8_t* cur, const uint8_t* prev) {
+      uint32_t col = 0;
+      while (col < numCols) {
+        uint32_t same = 0;
+        while (prev && col + same < numCols && same < MaxOpCount &&
+               memcmp(cur + (col + same) * numRings, prev + (col + same) * numRings, numRings) == 0)
+          same++;
+        if (same) {
+          out.push_back(OpSkipCols | (uint8_t)(same - 1));
+          col += same;
+          continue;
+        }
+        encodeColumn(out, cur + col * numRings, prev ? prev + col * numRings : nullptr);
+        col++;
+      }
+    }
+
+    // Skips for unchanged stretches, runs of 3 or more, literals for the rest
+    void encodeColumn(std::vector<uint8_t>& out, const uint8_t* cur, const uint8_t* prev) {
+      auto unchanged = [&](uint32_t r) { return prev && cur[r] == prev[r]; };
+      auto runLength = [&](uint32_t r) {
+        uint32_t n = 1;
+        while (r + n < numRings && n < MaxOpCount && cur[r + n] == cur[r])
+          n++;
+        return n;
+      };
+      uint32_t r = 0;
+      while (r < numRings) {
+        uint32_t n = 0;
+        if (unchanged(r)) {
+          while (r + n < numRings && n < MaxOpCount && unchanged(r + n))
+            n++;
+          out.push_back(OpSkip | (uint8_t)(n - 1));
+        } else if ((n = runLength(r)) >= 3) {
+          out.push_back(OpRun | (uint8_t)(n - 1));
+          out.push_back(cur[r]);
+        } else {
+          // a skip costs a byte, the same as one more literal, so only 2+ unchanged end it
+          n = 0;
+          while (r + n < numRings && n < MaxOpCount) {
+            uint32_t i = r + n;
+            if (n && unchanged(i) && (i + 1 == numRings || unchanged(i + 1)))
+              break;
+            if (n && runLength(i) >= 3)
+              break;
+            n++;
+          }
+          out.push_back(OpLiteral | (uint8_t)(n - 1));
+          out.insert(out.end(), cur + r, cur + r + n);
+        }
+        r += n;
+      }
+    }
+
+    uint32_t numRings;
+    uint32_t numCols;
+    uint32_t usPerFrame;
+    uint32_t keyInterval;
+    uint32_t worstError;
+    std::vector<Pixel> frameData;
+    std::vector<Pixel> palette;
+    std::vector<uint8_t> indices; // palette index of every pixel of every frame
+};
+
+// Runs demo for numFrames frames of enc.frameUs() on the host's manual clock and records
+// what the display would show: every column rendered, read through the demo's rotation.
+// With keyEvery, key (n % 12) is pressed (and released a frame later) every keyEvery frames
+inline void recordDemo(Demo& demo, AnimationEncoder& enc, uint32_t numFrames, uint32_t keyEvery = 0) {
+  uint32_t rings = enc.rings(), cols = enc.cols();
+  std::vector<Pixel> pixels(rings * cols), frame(rings * cols);
+  bool wasManual = hostClock.manual;
+  hostClock.manual = true;
+  hostClock.now = 0;
+  demo.setup(pixels.data(), rings, cols);
+  uint16_t keys = 0;
+  for (uint32_t f = 0; f < numFrames; f++) {
+    hostClock.now += enc.frameUs();
+    uint16_t next = keyEvery && f % keyEvery == 0 ? (uint16_t)(1 << (f / keyEvery % 12)) : 0;
+    if (next != keys) {
+      demo.processKeypress(next, next ^ keys);
+      keys = next;
+    }
+    demo.tick();
+    demo.renderColumns(0, cols);
+    RotatedView view(pixels.data(), rings, cols);
+    view.setRotation(demo.rotation());
+    for (uint32_t c = 0; c < cols; c++) {
+      for (uint32_t r = 0; r < rings; r++)
+        frame[indexAt(rings, c, r)] = view.get(c, r);
+    }
+    enc.addFrame(frame.data());
+  }
+  hostClock.manual = wasManual;
+}
+
+#endif // ifndef __ANIMATION_ENCODER_H
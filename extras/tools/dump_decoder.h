@@ -0,0 +1,139 @@
+#ifndef __DUMP_DECODER_H
+#define __DUMP_DECODER_H
+// Host side reader for frame_dump.h streams, used by tgraphics_undump and the tests.
+#include "frame_dump.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct DumpFrame {
+  DumpFormat format;
+  bool delta;          // was sent as a delta (pixels below are the whole frame either way)
+  uint32_t rings;
+  uint32_t cols;
+  uint32_t frame;
+  uint32_t timeUs;
+  std::vector<uint8_t> pixels; // as captured: FrameDump::bytesFor(rings, cols, format) bytes
+
+  uint32_t unitBytes() const { return format == DumpFormat::Rgb8 ? 3 : 6; }
+
+  // Channel c (0 blue, 1 green, 2 red; buffer order for Gs16) of the pixel at (col, ring)
+  uint32_t channel(uint32_t col, uint32_t ring, uint32_t c) const {
+    const uint8_t* p = &pixels[(size_t)indexAt(rings, col, ring) * unitBytes()];
+    return format == DumpFormat::Rgb8 ? p[2 - c] : (uint32_t)(p[2 * c] | p[2 * c + 1] << 8);
+  }
+};
+
+// Feed it bytes as they arrive, it calls back with every complete frame. Garbage before
+// the first 0 (joining mid-packet) is skipped, broken packets and deltas with nothing to
+// apply them to are counted as bad and skipped too
+class DumpDecoder {
+  public:
+    template <typename F>
+    void feed(const uint8_t* data, size_t n, F onFrame) {
+      for (size_t i = 0; i < n; i++) {
+        if (data[i] != 0) {
+          packet.push_back(data[i]);
+          continue;
+        }
+        if (unpack())
+          onFrame(last);
+        else if (synced) // the first one can be the tail of a packet we joined halfway
+          errors++;
+        synced = true;
+        packet.clear();
+      }
+    }
+
+    uint32_t bad() const { return errors; }
+
+    // Binary PPM, rings down and columns across. Rgb8 is 8 bit, the others 16 bit
+    static bool writePpm(const DumpFrame& f, const char* path) {
+      FILE* out = fopen(path, "wb");
+      if (!out)
+        return false;
+      bool wide = f.format != DumpFormat::Rgb8;
+      fprintf(out, "P6\n%u %u\n%u\n", f.cols, f.rings, wide ? 65535 : 255);
+      // PPM wants red first, channel() counts from blue (Rgb8 bytes are already red first)
+      static const uint32_t order[] = { 2, 1, 0 };
+      for (uint32_t ring = 0; ring < f.rings; ring++) {
+        for (uint32_t col = 0; col < f.cols; col++) {
+          for (uint32_t c = 0; c < 3; c++) {
+            uint32_t v = f.channel(col, ring, f.format == DumpFormat::Gs16 ? c : order[c]);
+            if (wide)
+              fputc(v >> 8, out);
+            fputc(v & 0xff, out);
+          }
+        }
+      }
+      return fclose(out) == 0;
+    }
+
+  private:
+    static uint32_t get16(const uint8_t* p) { return p[0] | (uint32_t)p[1] << 8; }
+    static uint32_t get32(const uint8_t* p) { return get16(p) | get16(p + 2) << 16; }
+
+    bool unpack() {
+      // COBS: each code byte is followed by code - 1 data bytes and stands for a 0
+      // (except 0xff, and the last one)
+      std::vector<uint8_t> raw;
+      size_t i = 0;
+      while (i < packet.size()) {
+        uint32_t code = packet[i++];
+        if (i + code - 1 > packet.size())
+          return false;
+        raw.insert(raw.end(), packet.begin() + i, packet.begin() + i + code - 1);
+        i += code - 1;
+        if (code != 0xff && i < packet.size())
+          raw.push_back(0);
+      }
+      if (raw.size() < DumpHeaderSize || raw[0] != DumpVersion || (raw[1] & ~DumpDelta) > (uint8_t)DumpFormat::Gs16)
+        return false;
+
+      DumpFrame f;
+      f.format = (DumpFormat)(raw[1] & ~DumpDelta);
+      f.delta = raw[1] & DumpDelta;
+      f.rings = get16(&raw[2]);
+      f.cols = get16(&raw[4]);
+      f.frame = get32(&raw[8]);
+      f.timeUs = get32(&raw[12]);
+      size_t frameBytes = FrameDump::bytesFor(f.rings, f.cols, f.format);
+      size_t unit = f.unitBytes();
+      const uint8_t* payload = raw.data() + DumpHeaderSize;
+      size_t payloadBytes = raw.size() - DumpHeaderSize;
+
+      if (!f.delta) {
+        if (payloadBytes != frameBytes)
+          return false;
+        f.pixels.assign(payload, payload + payloadBytes);
+      } else {
+        if (!haveLast || last.rings != f.rings || last.cols != f.cols || last.format != f.format)
+          return false;
+        f.pixels = last.pixels;
+        size_t at = 0, pos = 0;
+        while (pos < payloadBytes) {
+          if (pos + 4 > payloadBytes)
+            return false;
+          size_t skip = get16(payload + pos), count = get16(payload + pos + 2);
+          pos += 4;
+          at += skip * unit;
+          if (at + count * unit > frameBytes || pos + count * unit > payloadBytes)
+            return false;
+          memcpy(&f.pixels[at], payload + pos, count * unit);
+          at += count * unit;
+          pos += count * unit;
+        }
+      }
+      last = f;
+      haveLast = true;
+      return true;
+    }
+
+    std::vector<uint8_t> packet;
+    DumpFrame last;
+    bool haveLast = false;
+    bool synced = false;
+    uint32_t errors = 0;
+};
+
+#endif // ifndef __DUMP_DECODER_H
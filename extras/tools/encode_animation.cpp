@@ -0,0 +1,132 @@
+// Records one of the library's demos into a compressed animation (animation_stream.h)
+// and checks it decodes back to the quantized frames.
+//
+//   tgraphics_encode <demo> <rings> <cols> <frames> <frameUs> <out> [--keys N] [--keyframe N] [--name ident]
+//
+// demo is flash, rainbow, ring or fireworks. --keys presses a key every N frames (demos
+// like fireworks do nothing without). out ending in .h is written as a C array to
+// #include in a sketch, anything else as the raw container.
+#include "animation_encoder.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+static int usage() {
+  fprintf(stderr, "usage: tgraphics_encode <flash|rainbow|ring|fireworks> <rings> <cols> <frames> <frameUs> <out>"
+                  " [--keys N] [--keyframe N] [--name ident]\n");
+  return 2;
+}
+
+static bool writeHeader(const char* path, const std::string& name, const std::vector<uint8_t>& data,
+                        const char* demo, const AnimationEncoder& enc) {
+  FILE* f = fopen(path, "w");
+  if (!f)
+    return false;
+  fprintf(f, "// %s, %u rings x %u cols, %u frames of %uus. Made by tgraphics_encode\n", demo, enc.rings(),
+          enc.cols(), enc.frames(), enc.frameUs());
+  fprintf(f, "#include <cstdint>\n\nalignas(4) const uint8_t %s[] = {", name.c_str());
+  for (size_t i = 0; i < data.size(); i++)
+    fprintf(f, "%s0x%02x,", i % 16 ? " " : "\n  ", data[i]);
+  fprintf(f, "\n};\n");
+  return fclose(f) == 0;
+}
+
+static bool writeBinary(const char* path, const std::vector<uint8_t>& data) {
+  FILE* f = fopen(path, "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+// Plays the container back, frame by frame and from every keyframe
+static bool verify(const std::vector<uint8_t>& data, const AnimationEncoder& enc) {
+  AnimationDecoder anim;
+  if (!anim.open(data.data(), (uint32_t)data.size()))
+    return false;
+  uint32_t frameSize = enc.rings() * enc.cols();
+  std::vector<Pixel> pixels(frameSize);
+  auto matches = [&](uint32_t frame) {
+    for (uint32_t i = 0; i < frameSize; i++) {
+      Pixel want = enc.decoded(frame, i);
+      if (memcmp(&pixels[i], &want, sizeof(Pixel)) != 0)
+        return false;
+    }
+    return true;
+  };
+  for (uint32_t f = 0; f < enc.frames(); f++) {
+    anim.decodeFrame(pixels.data());
+    if (!matches(f))
+      return false;
+  }
+  for (uint32_t f = 0; f < enc.frames(); f += anim.keyframeInterval() + 1) {
+    anim.seek(f, pixels.data());
+    anim.decodeFrame(pixels.data());
+    if (!matches(f))
+      return false;
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 7)
+    return usage();
+  const char* demoName = argv[1];
+  uint32_t rings = atoi(argv[2]), cols = atoi(argv[3]), frames = atoi(argv[4]), frameUs = atoi(argv[5]);
+  const char* out = argv[6];
+  uint32_t keyEvery = 0, keyframe = 32;
+  std::string name = "animation";
+  for (int i = 7; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--keys") == 0)
+      keyEvery = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "--keyframe") == 0)
+      keyframe = atoi(argv[i + 1]);
+    else if (strcmp(argv[i], "--name") == 0)
+      name = argv[i + 1];
+    else
+      return usage();
+  }
+  if (!rings || !cols || !frames || rings > 0xffff || cols > MaxSweepColumns || frames > 0xffff)
+    return usage();
+  if (!keyframe || keyframe > 0xffff) {
+    fprintf(stderr, "--keyframe must be 1 - 65535\n");
+    return usage();
+  }
+
+  SimpleFlash flash(Colors::Red, 100000, 0.5f);
+  RainbowWheel rainbow(0.5f, 20000);
+  rainbow.setRotationAware(true); // frames are read through a RotatedView, keeps sub-column turns
+  RingDemo ring(0.5f, 10000);
+  Fireworks fireworks(0.5f);
+  Demo* demo = nullptr;
+  if (strcmp(demoName, "flash") == 0)
+    demo = &flash;
+  else if (strcmp(demoName, "rainbow") == 0)
+    demo = &rainbow;
+  else if (strcmp(demoName, "ring") == 0)
+    demo = &ring;
+  else if (strcmp(demoName, "fireworks") == 0)
+    demo = &fireworks;
+  else
+    return usage();
+
+  AnimationEncoder enc(rings, cols, frameUs, keyframe);
+  recordDemo(*demo, enc, frames, keyEvery);
+  std::vector<uint8_t> data = enc.encode();
+
+  size_t ext = strlen(out);
+  bool header = ext > 2 && strcmp(out + ext - 2, ".h") == 0;
+  if (!(header ? writeHeader(out, name, data, demoName, enc) : writeBinary(out, data))) {
+    fprintf(stderr, "can't write %s\n", out);
+    return 1;
+  }
+  uint64_t raw = (uint64_t)rings * cols * frames * sizeof(Pixel);
+  printf("%s: %u frames, %zu colors (max error %u), %zu bytes, %.1fx smaller than raw Pixels\n", out, frames,
+         enc.colors().size(), enc.maxError(), data.size(), (double)raw / data.size());
+  if (!verify(data, enc)) {
+    fprintf(stderr, "decoding %s doesn't give the recorded frames back\n", out);
+    return 1;
+  }
+  return 0;
+}
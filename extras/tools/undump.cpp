@@ -0,0 +1,43 @@
+// Turns a frame_dump.h stream into one PPM image per frame.
+//
+//   tgraphics_undump <stream> <prefix>
+//
+// stream is a file captured from the serial port, a tty, or - for stdin (e.g. piped
+// from `cat /dev/ttyACM0`). Frame n is written to <prefix>_<n>.ppm.
+#include "dump_decoder.h"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: tgraphics_undump <stream|-> <prefix>\n");
+    return 2;
+  }
+  bool useStdin = std::string(argv[1]) == "-";
+  FILE* in = useStdin ? stdin : fopen(argv[1], "rb");
+  if (!in) {
+    fprintf(stderr, "can't open %s\n", argv[1]);
+    return 1;
+  }
+  DumpDecoder decoder;
+  uint32_t frames = 0, failed = 0;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+    decoder.feed(buf, n, [&](const DumpFrame& f) {
+      std::string path = std::string(argv[2]) + "_" + std::to_string(f.frame) + ".ppm";
+      if (!DumpDecoder::writePpm(f, path.c_str())) {
+        failed++;
+        return;
+      }
+      printf("%s: %ux%u %s%s at %uus\n", path.c_str(), f.cols, f.rings,
+             f.format == DumpFormat::Rgb8 ? "rgb8" : f.format == DumpFormat::Gs16 ? "gs16" : "pixel16",
+             f.delta ? " delta" : "", f.timeUs);
+      frames++;
+    });
+  }
+  if (!useStdin)
+    fclose(in);
+  printf("%u frames, %u bad packets\n", frames, decoder.bad());
+  return failed ? 1 : 0;
+}
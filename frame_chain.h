@@ -0,0 +1,159 @@
+#ifndef __FRAME_CHAIN_H
+#define __FRAME_CHAIN_H
+#include "tgraphics.h"
+#include <atomic>
+#include <cstdint>
+
+// Double/triple buffered frames shared between the render loop and the display ISR
+// The render loop only ever touches back(), the display only ever reads acquire()/front(),
+// and handing a frame over is a single atomic exchange on a byte: no locks, no copies
+// unless copy-forward is on (see setCopyForward).
+
+/*-- How buffers move around (triple buffering):
+
+        render loop            shared slot            display ISR
+        back()  -- publish() -->  ready  -- acquire() -->  front()
+
+    publish() swaps back with the shared slot, acquire() swaps front with it if it holds
+    a new frame. With double buffering there is no shared slot: publish() marks back as
+    pending and acquire() flips front/back, so the render loop has to wait for canRender().
+
+    The buffer back() hands out next is whatever the display let go of, two frames old
+    with triple buffering. Demos that only draw what changed need copy-forward, which
+    copies the last published frame into back() before the render loop gets it.
+
+*/
+
+// Plain interleaved frame, for demos that draw into a Pixel* (see Demo::setBuffer)
+template <uint32_t Rings, uint32_t Cols>
+struct PixelFrame {
+  static const uint32_t rings = Rings;
+  static const uint32_t cols = Cols;
+  Pixel pixels[Rings * Cols];
+};
+
+template <typename Buffer, uint8_t Count = 3>
+class FrameChain {
+  static_assert(Count == 2 || Count == 3, "FrameChain supports double or triple buffering");
+
+  public:
+    FrameChain() {
+      reset();
+    }
+
+    // Back to the initial buffer assignment, only call while the display is stopped
+    void reset() {
+      backIndex = 0;
+      frontIndex = Count - 1;
+      state.store(Count == 3 ? 1 : frontIndex);
+      copyPending = false;
+      resetStats();
+    }
+
+    // On: back() always starts out as a copy of the last published frame, so demos can
+    // keep drawing incrementally. Costs one frame copy per published frame.
+    void setCopyForward(bool on) { copyForward = on; }
+
+    //------ Render side ------//
+
+    // With double buffering only call once canRender() is true
+    Buffer& back() {
+      uint8_t i = Count == 3 ? backIndex : backIndexDouble();
+      // the published frame is only ever read by the display, so it's safe to copy from
+      if (copyPending) {
+        buffers[i] = buffers[publishedIndex];
+        copyPending = false;
+      }
+      return buffers[i];
+    }
+
+    // Double buffering: false until the display picked up the last published frame
+    bool canRender() const {
+      return Count == 3 || !(state.load(std::memory_order_acquire) & Fresh);
+    }
+
+    // Hands back() to the display, a frame that was never displayed counts as dropped
+    void publish() {
+      uint8_t prev;
+      if (Count == 3) {
+        publishedIndex = backIndex;
+        prev = state.exchange(backIndex | Fresh, std::memory_order_acq_rel);
+        backIndex = prev & IndexMask;
+      } else {
+        publishedIndex = backIndexDouble();
+        prev = state.fetch_or(Fresh, std::memory_order_acq_rel);
+      }
+      copyPending = copyForward;
+      if (prev & Fresh)
+        bump(droppedFrames);
+      bump(publishedFrames);
+    }
+
+    //------ Display side (ISR) ------//
+
+    // Latest published frame. If nothing new was published, the current front is shown
+    // again and counted as a late frame.
+    const Buffer& acquire() {
+      uint8_t s = state.load(std::memory_order_acquire);
+      if (s & Fresh) {
+        if (Count == 3) {
+          frontIndex = state.exchange(frontIndex, std::memory_order_acq_rel) & IndexMask;
+        } else {
+          frontIndex ^= 1;
+          state.store(frontIndex, std::memory_order_release);
+        }
+      } else {
+        bump(lateFrames);
+      }
+      bump(displayedFrames);
+      return buffers[frontIndex];
+    }
+
+    const Buffer& front() const { return buffers[frontIndex]; }
+
+    //------ Stats, safe to read from either side ------//
+
+    uint32_t published() const { return publishedFrames.load(std::memory_order_relaxed); }
+    uint32_t dropped() const { return droppedFrames.load(std::memory_order_relaxed); }
+    uint32_t displayed() const { return displayedFrames.load(std::memory_order_relaxed); }
+    uint32_t late() const { return lateFrames.load(std::memory_order_relaxed); }
+
+    void resetStats() {
+      publishedFrames.store(0);
+      droppedFrames.store(0);
+      displayedFrames.store(0);
+      lateFrames.store(0);
+    }
+
+    // Direct access, e.g. to clear every buffer before starting
+    Buffer& buffer(uint8_t i) { return buffers[i]; }
+    static uint8_t count() { return Count; }
+
+  private:
+    static const uint8_t Fresh = 0x80;
+    static const uint8_t IndexMask = 0x7f;
+
+    // Each counter has a single writer, so a relaxed load/store is enough
+    static void bump(std::atomic<uint32_t>& counter) {
+      counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    uint8_t backIndexDouble() const {
+      return (state.load(std::memory_order_acquire) & IndexMask) ^ 1;
+    }
+
+    Buffer buffers[Count];
+    // Triple: index of the shared slot (+ Fresh). Double: index of front (+ Fresh = pending)
+    std::atomic<uint8_t> state;
+    uint8_t backIndex;      // render side only
+    uint8_t frontIndex;     // display side only
+    uint8_t publishedIndex; // render side only, last frame handed over
+    bool copyForward = false;
+    bool copyPending;       // render side only, back() still has to copy publishedIndex in
+    std::atomic<uint32_t> publishedFrames;
+    std::atomic<uint32_t> droppedFrames;
+    std::atomic<uint32_t> displayedFrames;
+    std::atomic<uint32_t> lateFrames;
+};
+
+#endif // ifndef __FRAME_CHAIN_H
@@ -0,0 +1,208 @@
+#include "frame_dump.h"
+#include <Arduino.h> // micros
+#include <cstring>
+
+enum : uint8_t {
+  StageHeader,
+  StageFull,
+  StageRecords,
+  StageDone,
+};
+
+// A delta record ends after this many unchanged pixels in a row, a new record header
+// (4 bytes) is cheaper than sending them again
+static const uint32_t RecordBreak = 4;
+
+static inline void put16(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, v & 0xffff);
+  put16(p + 2, v >> 16);
+}
+
+FrameDump::FrameDump(uint8_t* snap, uint8_t* ref, uint32_t storageBytes) {
+  snapshot = snap;
+  reference = ref;
+  storage = storageBytes;
+  delta = false;
+  keyframeEvery = 16;
+  sinceKeyframe = 0;
+  refValid = false;
+  refRings = refCols = 0;
+  refFormat = DumpFormat::Pixel16;
+  sending = false;
+  isDelta = false;
+  unitBytes = numUnits = unit = pendingData = 0;
+  seg = nullptr;
+  segLeft = 0;
+  stage = StageDone;
+  blockLen = 0;
+  txHead = txTail = 0;
+  numDumps = numDropped = 0;
+}
+
+void FrameDump::setDelta(bool on, uint32_t keyEvery) {
+  delta = on && reference != nullptr;
+  keyframeEvery = keyEvery;
+  refValid = false;
+}
+
+bool FrameDump::begin(uint32_t rings, uint32_t cols, DumpFormat format, uint32_t frameNumber) {
+  if (sending || rings > 0xffff || cols > 0xffff || bytesFor(rings, cols, format) > storage) {
+    numDropped++;
+    return false;
+  }
+  isDelta = delta && refValid && refRings == rings && refCols == cols && refFormat == format &&
+            (keyframeEvery == 0 || sinceKeyframe + 1 < keyframeEvery);
+  sinceKeyframe = isDelta ? sinceKeyframe + 1 : 0;
+  refRings = rings;
+  refCols = cols;
+  refFormat = format;
+
+  header[0] = DumpVersion;
+  header[1] = (uint8_t)format | (isDelta ? DumpDelta : 0);
+  put16(header + 2, rings);
+  put16(header + 4, cols);
+  put16(header + 6, 0);
+  put32(header + 8, frameNumber);
+  put32(header + 12, micros());
+
+  unitBytes = format == DumpFormat::Rgb8 ? 3 : 6;
+  numUnits = rings * cols;
+  unit = 0;
+  pendingData = 0;
+  segLeft = 0;
+  stage = StageHeader;
+  blockLen = 0;
+  sending = true;
+  return true;
+}
+
+bool FrameDump::capture(const Pixel* pixels, uint32_t rings, uint32_t cols, DumpFormat format, uint32_t frameNumber) {
+  TGRAPHICS_PROBE("FrameDump::capture");
+  if (!begin(rings, cols, format, frameNumber))
+    return false;
+  if (format == DumpFormat::Rgb8) {
+    uint8_t* out = snapshot;
+    for (uint32_t i = 0; i < numUnits; i++, out += 3) {
+      out[0] = pixels[i].red > 0xff ? 0xff : (uint8_t)pixels[i].red;
+      out[1] = pixels[i].green > 0xff ? 0xff : (uint8_t)pixels[i].green;
+      out[2] = pixels[i].blue > 0xff ? 0xff : (uint8_t)pixels[i].blue;
+    }
+  } else if (NativeOrder == ChannelOrder::BGR) {
+    memcpy(snapshot, pixels, numUnits * sizeof(Pixel)); // little endian, so already in order
+  } else {
+    uint8_t* out = snapshot;
+    for (uint32_t i = 0; i < numUnits; i++, out += 6) {
+      const uint16_t c[3] = { pixels[i].blue, pixels[i].green, pixels[i].red };
+      memcpy(out, c, 6);
+    }
+  }
+  return true;
+}
+
+bool FrameDump::captureGs(const uint16_t* gs, uint32_t numLeds, uint32_t cols, uint32_t frameNumber) {
+  if (!begin(numLeds, cols, DumpFormat::Gs16, frameNumber))
+    return false;
+  memcpy(snapshot, gs, numUnits * 3 * sizeof(uint16_t));
+  return true;
+}
+
+// Points seg at the next run of packet bytes, false once the packet is complete
+bool FrameDump::nextSegment() {
+  switch (stage) {
+    case StageHeader:
+      seg = header;
+      segLeft = DumpHeaderSize;
+      stage = isDelta ? StageRecords : StageFull;
+      return true;
+    case StageFull:
+      seg = snapshot;
+      segLeft = numUnits * unitBytes;
+      stage = StageDone;
+      return true;
+    case StageRecords: {
+      if (pendingData) {
+        seg = snapshot + unit * unitBytes;
+        segLeft = pendingData * unitBytes;
+        unit += pendingData;
+        pendingData = 0;
+        return true;
+      }
+      auto unchanged = [&](uint32_t u) {
+        return memcmp(snapshot + u * unitBytes, reference + u * unitBytes, unitBytes) == 0;
+      };
+      uint32_t skip = 0;
+      while (unit + skip < numUnits && skip < 0xffff && unchanged(unit + skip))
+        skip++;
+      if (unit + skip == numUnits) {
+        stage = StageDone; // the rest is unchanged, no record needed
+        return false;
+      }
+      unit += skip;
+      uint32_t count = 0, same = 0;
+      while (unit + count < numUnits && count < 0xffff) {
+        same = unchanged(unit + count) ? same + 1 : 0;
+        count++;
+        if (same == RecordBreak)
+          break;
+      }
+      count -= same; // trailing unchanged pixels start the next record's skip
+      put16(record, skip);
+      put16(record + 2, count);
+      pendingData = count;
+      seg = record;
+      segLeft = 4;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+// Feeds the packet through the COBS encoder while there's room for a whole block
+void FrameDump::fill() {
+  while (sending && txFree() >= sizeof(block) + 2) {
+    if (segLeft == 0) {
+      if (nextSegment())
+        continue;
+      cobsFlush();
+      txPut(0); // end of packet
+      sending = false;
+      numDumps++;
+      if (delta) { // this dump is what the next delta is against
+        uint8_t* t = reference;
+        reference = snapshot;
+        snapshot = t;
+        refValid = true;
+      }
+      break;
+    }
+    cobsPush(*seg++);
+    segLeft--;
+  }
+}
+
+void FrameDump::cobsPush(uint8_t b) {
+  if (b == 0) {
+    cobsFlush(); // the code byte stands in for the 0
+    return;
+  }
+  block[blockLen++] = b;
+  if (blockLen == sizeof(block)) { // longest block, code 0xff has no 0 after it
+    txPut(0xff);
+    for (uint32_t i = 0; i < blockLen; i++)
+      txPut(block[i]);
+    blockLen = 0;
+  }
+}
+
+void FrameDump::cobsFlush() {
+  txPut((uint8_t)(blockLen + 1));
+  for (uint32_t i = 0; i < blockLen; i++)
+    txPut(block[i]);
+  blockLen = 0;
+}
@@ -0,0 +1,146 @@
+#ifndef __FRAME_DUMP_H
+#define __FRAME_DUMP_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Binary frame snapshots over Serial, instead of vecPrint()'s hex text
+// capture() copies the frame (so the demo can keep drawing into it), and service() sends
+// as much of it as the port will take right now without blocking, so a whole frame can
+// trickle out over many ticks. Every dump is one COBS packet ending in a 0 byte, so a
+// reader can join at any point and resync on the next 0.
+// With a second buffer to remember the last dump, dumps can be deltas: only the runs of
+// pixels that changed since then are sent.
+// extras/tools/tgraphics_undump turns a captured stream into image files.
+//
+//   static uint8_t snap[FrameDump::bytesFor(32, 256, DumpFormat::Rgb8)];
+//   static uint8_t ref[sizeof(snap)];
+//   FrameDump dump(snap, ref, sizeof(snap));
+//   ...on a key press, or every so often:
+//   dump.capture(pixels, 32, 256, DumpFormat::Rgb8, frameNumber);
+//   ...every loop:
+//   dump.service(Serial);
+
+/*-- Packet, before COBS (all little endian):
+
+    0   version (2)
+    1   format, | DumpDelta for a delta
+    2   rings, cols                           (uint16 each)
+    6   0                                     (uint16)
+    8   frame number, micros() at capture     (uint32 each)
+    16  full: every pixel, column by column (indexAt order)
+        delta: records of { skip, count } (uint16 each) and count pixels: skip pixels
+        are the same as last dump, then count new ones. Pixels after the last record
+        are unchanged.
+
+*/
+
+enum class DumpFormat : uint8_t {
+  Pixel16, // blue, green, red as uint16 (the Pixel itself with the default BGR order)
+  Rgb8,    // red, green, blue bytes, channels over 0xff saturate
+  Gs16,    // 3 raw uint16 per LED from a GS buffer (printGsBuffer), in buffer order
+};
+
+const uint8_t DumpVersion = 2; // 1 had Rgb8 in blue, green, red order
+const uint8_t DumpDelta = 0x80;
+const uint32_t DumpHeaderSize = 16;
+const uint32_t DumpTxBytes = 512; // staging between the encoder and the port
+
+class FrameDump {
+  public:
+    // Bytes a snapshot takes, the size both buffers need
+    static constexpr uint32_t bytesFor(uint32_t rings, uint32_t cols, DumpFormat format) {
+      return rings * cols * (format == DumpFormat::Rgb8 ? 3 : 6);
+    }
+
+    // reference = nullptr: full dumps only
+    FrameDump(uint8_t* snapshot, uint8_t* reference, uint32_t storageBytes);
+
+    // Deltas against the last dump (needs a reference buffer). Every keyframeEvery-th
+    // dump is sent whole anyway, so a reader joining late catches up (0 = never)
+    void setDelta(bool on, uint32_t keyframeEvery = 16);
+    // The next dump is sent whole
+    void forceKeyframe() { refValid = false; }
+
+    // Starts a dump. False (and counted as dropped) if the last one is still going out
+    // or the frame doesn't fit the buffers
+    bool capture(const Pixel* pixels, uint32_t rings, uint32_t cols, DumpFormat format, uint32_t frameNumber);
+    // A GS buffer, 3 values per LED, numLeds per column
+    bool captureGs(const uint16_t* gs, uint32_t numLeds, uint32_t cols, uint32_t frameNumber);
+
+    bool busy() const { return sending || txHead != txTail; }
+    uint32_t dumps() const { return numDumps; }
+    uint32_t dropped() const { return numDropped; }
+
+    // Writes what port can take without blocking (availableForWrite()), call every loop.
+    // Port is anything with availableForWrite() and write(const uint8_t*, size_t):
+    // Serial, Serial1, or a file in the host tests. Returns the bytes written
+    template <typename Port>
+    uint32_t service(Port& port) {
+      fill();
+      uint32_t written = 0;
+      while (txHead != txTail) {
+        int room = port.availableForWrite();
+        if (room <= 0)
+          break;
+        uint32_t start = txTail % DumpTxBytes;
+        uint32_t n = txHead - txTail;
+        n = n < DumpTxBytes - start ? n : DumpTxBytes - start; // up to the end of the ring
+        n = n < (uint32_t)room ? n : (uint32_t)room;
+        n = (uint32_t)port.write(tx + start, n);
+        if (n == 0)
+          break;
+        txTail += n;
+        written += n;
+        fill();
+      }
+      return written;
+    }
+
+  private:
+    bool begin(uint32_t rings, uint32_t cols, DumpFormat format, uint32_t frameNumber);
+    void fill();
+    bool nextSegment();
+    void cobsPush(uint8_t b);
+    void cobsFlush();
+    void txPut(uint8_t b) { tx[txHead++ % DumpTxBytes] = b; }
+    uint32_t txFree() const { return DumpTxBytes - (txHead - txTail); }
+
+    uint8_t* snapshot;
+    uint8_t* reference;
+    uint32_t storage;
+    bool delta;
+    uint32_t keyframeEvery;
+    uint32_t sinceKeyframe;
+
+    // what the reference holds
+    bool refValid;
+    uint32_t refRings;
+    uint32_t refCols;
+    DumpFormat refFormat;
+
+    // the dump going out
+    bool sending;
+    bool isDelta;
+    uint32_t unitBytes; // bytes per pixel
+    uint32_t numUnits;
+    uint32_t unit;      // next pixel to look at (deltas)
+    uint32_t pendingData; // pixels of the current delta record still to send
+    uint8_t header[DumpHeaderSize];
+    uint8_t record[4];  // { skip, count } of the current delta record
+    const uint8_t* seg; // bytes being fed to the encoder
+    uint32_t segLeft;
+    uint8_t stage;      // header, whole payload or delta records, then done
+
+    // COBS: up to 254 non-zero bytes wait here for their code byte
+    uint8_t block[254];
+    uint32_t blockLen;
+
+    uint8_t tx[DumpTxBytes];
+    uint32_t txHead; // free running
+    uint32_t txTail;
+
+    uint32_t numDumps;
+    uint32_t numDropped;
+};
+
+#endif // ifndef __FRAME_DUMP_H
@@ -0,0 +1,38 @@
+#include "framebuffer.h"
+
+FrameBuffer::FrameBuffer(uint16_t* storage, uint32_t rings, uint32_t cols) {
+  planes = storage;
+  numRings = rings;
+  numCols = cols;
+  stride = colStrideFor(rings);
+  clear();
+}
+
+void FrameBuffer::clear() {
+  memset(planes, 0, 3 * planeSize() * sizeof(uint16_t));
+}
+
+void FrameBuffer::load(const Pixel* src) {
+  for (uint32_t col = 0; col < numCols; col++) {
+    PixelSpan dst = column(col);
+    const Pixel* srcCol = src + indexAt(numRings, col, 0);
+    for (uint32_t ring = 0; ring < numRings; ring++) {
+      dst.blue[ring] = srcCol[ring].blue;
+      dst.green[ring] = srcCol[ring].green;
+      dst.red[ring] = srcCol[ring].red;
+    }
+  }
+}
+
+void FrameBuffer::store(Pixel* dst) const {
+  const uint16_t* b = plane(Channel::Blue);
+  const uint16_t* g = plane(Channel::Green);
+  const uint16_t* r = plane(Channel::Red);
+  for (uint32_t col = 0; col < numCols; col++) {
+    Pixel* dstCol = dst + indexAt(numRings, col, 0);
+    uint32_t base = index(col, 0);
+    for (uint32_t ring = 0; ring < numRings; ring++) {
+      dstCol[ring] = { b[base + ring], g[base + ring], r[base + ring] };
+    }
+  }
+}
@@ -0,0 +1,212 @@
+#ifndef __FRAMEBUFFER_H
+#define __FRAMEBUFFER_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Planar (structure of arrays) frame buffer
+// Each color channel is its own plane of uint16_t, stored column-major like indexAt():
+// a column (one line of the sweep) is a contiguous run of rings.
+// Columns are padded to a multiple of 8 elements (16 bytes) so every column starts
+// aligned for wide loads, and each plane can go straight through the vec* kernels.
+
+/*-- Plane layout (colStride >= rings):
+
+        col 0: [ring 0 ... ring N-1 | pad]
+        col 1: [ring 0 ... ring N-1 | pad]
+        ...
+
+*/
+
+enum class Channel : uint8_t {
+  Blue = 0,
+  Green = 1,
+  Red = 2,
+};
+
+// A strided line of pixels across the three planes
+// Column views have stride 1 (sweep order), ring views have stride colStride
+struct PixelSpan {
+  uint16_t* blue;
+  uint16_t* green;
+  uint16_t* red;
+  uint32_t size;
+  uint32_t stride;
+
+  Pixel get(uint32_t i) const {
+    uint32_t o = i * stride;
+    return { blue[o], green[o], red[o] };
+  }
+
+  void set(uint32_t i, const Pixel& p) {
+    uint32_t o = i * stride;
+    blue[o] = p.blue;
+    green[o] = p.green;
+    red[o] = p.red;
+  }
+
+  uint16_t* channel(Channel c) const {
+    return c == Channel::Blue ? blue : c == Channel::Green ? green : red;
+  }
+};
+
+class FrameBuffer {
+  public:
+    static const uint32_t colAlign = 8; // in uint16_t elements
+
+    // storage must hold storageElems(rings, cols) uint16_t and should be 16-byte aligned
+    FrameBuffer(uint16_t* storage, uint32_t rings, uint32_t cols);
+
+    static uint32_t colStrideFor(uint32_t rings) {
+      return (rings + colAlign - 1) & ~(colAlign - 1);
+    }
+    static uint32_t storageElems(uint32_t rings, uint32_t cols) {
+      return 3 * colStrideFor(rings) * cols;
+    }
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    uint32_t colStride() const { return stride; }
+    uint32_t planeSize() const { return stride * numCols; } // elements per plane, padding included
+    uint32_t numPixels() const { return numRings * numCols; }
+
+    // Same idea as indexAt(), but into a plane
+    uint32_t index(uint32_t col, uint32_t ring) const { return col * stride + ring; }
+
+    uint16_t* plane(Channel c) { return planes + (uint32_t)c * planeSize(); }
+    const uint16_t* plane(Channel c) const { return planes + (uint32_t)c * planeSize(); }
+
+    Pixel get(uint32_t col, uint32_t ring) const {
+      uint32_t i = index(col, ring);
+      return { plane(Channel::Blue)[i], plane(Channel::Green)[i], plane(Channel::Red)[i] };
+    }
+
+    void set(uint32_t col, uint32_t ring, const Pixel& p) {
+      uint32_t i = index(col, ring);
+      plane(Channel::Blue)[i] = p.blue;
+      plane(Channel::Green)[i] = p.green;
+      plane(Channel::Red)[i] = p.red;
+    }
+
+    // Sweep order: all rings of one column, contiguous
+    PixelSpan column(uint32_t col) {
+      uint32_t i = index(col, 0);
+      return { plane(Channel::Blue) + i, plane(Channel::Green) + i, plane(Channel::Red) + i, numRings, 1 };
+    }
+
+    // Ring order: one ring across every column, strided by colStride()
+    PixelSpan ring(uint32_t ring) {
+      return { plane(Channel::Blue) + ring, plane(Channel::Green) + ring, plane(Channel::Red) + ring, numCols, stride };
+    }
+
+    void clear();
+
+    // Convert from/to an interleaved Pixel buffer addressed with indexAt(rings, col, ring)
+    void load(const Pixel* src);
+    void store(Pixel* dst) const;
+
+  private:
+    uint16_t* planes;
+    uint32_t numRings;
+    uint32_t numCols;
+    uint32_t stride;
+};
+
+// FrameBuffer that owns its (static/member) storage
+template <uint32_t Rings, uint32_t Cols>
+class StaticFrameBuffer : public FrameBuffer {
+  public:
+    StaticFrameBuffer() : FrameBuffer(storage, Rings, Cols) {}
+  private:
+    alignas(16) uint16_t storage[3 * ((Rings + colAlign - 1) & ~(colAlign - 1)) * Cols];
+};
+
+
+//-------------------------//
+
+// Per plane vec* kernels. Buffers must have the same dimensions.
+// Padding is processed too, it never leaks into visible pixels.
+
+//-------------------------//
+
+inline void vecFill(const Pixel src, FrameBuffer& dst) {
+  uint32_t n = dst.planeSize();
+  uint16_t* b = dst.plane(Channel::Blue);
+  uint16_t* g = dst.plane(Channel::Green);
+  uint16_t* r = dst.plane(Channel::Red);
+  for (uint32_t i = 0; i < n; i++) {
+    b[i] = src.blue;
+    g[i] = src.green;
+    r[i] = src.red;
+  }
+}
+
+inline void vecFill(const FrameBuffer& src, FrameBuffer& dst) {
+  memcpy(dst.plane(Channel::Blue), src.plane(Channel::Blue), 3 * src.planeSize() * sizeof(uint16_t));
+}
+
+// dst += src, saturating
+inline void vecAdd(const FrameBuffer& src, FrameBuffer& dst) {
+  vecQAdd16(dst.plane(Channel::Blue), src.plane(Channel::Blue), dst.plane(Channel::Blue), 3 * dst.planeSize());
+}
+
+inline void vecFade(const FrameBuffer& src, FrameBuffer& dst, uint16_t fadeAmt) {
+  vecQSub16(src.plane(Channel::Blue), fadeAmt, dst.plane(Channel::Blue), 3 * dst.planeSize());
+}
+
+// Fade each channel by its own amount
+inline void vecFade(const FrameBuffer& src, FrameBuffer& dst, const Pixel& fadeAmt) {
+  uint32_t n = dst.planeSize();
+  vecQSub16(src.plane(Channel::Blue), fadeAmt.blue, dst.plane(Channel::Blue), n);
+  vecQSub16(src.plane(Channel::Green), fadeAmt.green, dst.plane(Channel::Green), n);
+  vecQSub16(src.plane(Channel::Red), fadeAmt.red, dst.plane(Channel::Red), n);
+}
+
+inline void vecBrighten(const FrameBuffer& src, FrameBuffer& dst, uint16_t fadeAmt) {
+  vecQAdd16(src.plane(Channel::Blue), fadeAmt, dst.plane(Channel::Blue), 3 * dst.planeSize());
+}
+
+inline void vecScale(const FrameBuffer& src, FrameBuffer& dst, Scale16 scale) {
+  vecScale(src.plane(Channel::Blue), dst.plane(Channel::Blue), scale, 3 * dst.planeSize());
+}
+
+// dst = a * frac + b * (1 - frac), frac in Q0.16
+inline void vecLerp(const FrameBuffer& a, const FrameBuffer& b, FrameBuffer& dst, uint16_t frac) {
+  uint32_t weight = fracWeight16(frac);
+  uint32_t n = 3 * dst.planeSize();
+  const uint16_t* pa = a.plane(Channel::Blue);
+  const uint16_t* pb = b.plane(Channel::Blue);
+  uint16_t* pd = dst.plane(Channel::Blue);
+  for (uint32_t i = 0; i < n; i++) {
+    pd[i] = lerp16(pa[i], pb[i], weight);
+  }
+}
+
+// Separable convolution of each plane, kernelRings runs along a column (across the rings)
+// and kernelCols across the columns (along the sweep). src and dst must be different buffers.
+// edges.along applies across the rings, edges.across across the columns (see Cylindrical)
+inline void convolveSeparable(const FrameBuffer& src,
+                              FrameBuffer& dst,
+                              const Kernel15& kernelRings,
+                              const Kernel15& kernelCols,
+                              EdgePolicy edges) {
+  ImageLayout layout = { src.rings(), src.cols(), src.colStride(), 1 };
+  for (uint8_t c = 0; c < 3; c++) {
+    convolveSeparable(src.plane((Channel)c), dst.plane((Channel)c), layout,
+                      kernelRings, kernelCols, edges);
+  }
+}
+
+inline void convolveSeparable(const FrameBuffer& src,
+                              FrameBuffer& dst,
+                              const Kernel15& kernelRings,
+                              const Kernel15& kernelCols,
+                              EdgeType edgeHandling) {
+  convolveSeparable(src, dst, kernelRings, kernelCols, { edgeHandling, edgeHandling });
+}
+
+// Defaults to Cylindrical: blends the first and last columns, clamps at the inner/outer rings
+inline void blur2d(const FrameBuffer& src, FrameBuffer& dst, EdgePolicy edges = Cylindrical) {
+  convolveSeparable(src, dst, Box3, Box3, edges);
+}
+
+#endif // ifndef __FRAMEBUFFER_H
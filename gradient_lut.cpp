@@ -0,0 +1,4 @@
+#include "gradient_lut.h"
+
+// constexpr, so the table is still baked by the compiler and lands in flash
+constexpr GradientLUT<256> rainbow12LUT(rainbow12, 12);
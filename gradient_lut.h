@@ -0,0 +1,65 @@
+#ifndef __GRADIENT_LUT_H
+#define __GRADIENT_LUT_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Palette baked into an N entry table, so a hue sweep is one table read instead of
+// rainbowAt()'s modf + float lerp. Entries interpolate between palette colors the same
+// way rainbowAt() does, wrapping from the last color back to the first.
+// Build it at compile time:  constexpr GradientLUT<256> lut(rainbow7, 7);
+// or at setup:               GradientLUT<256> lut; lut.bake(myPalette, size);
+
+// 16-bit phase of col out of numCols, i.e. col / numCols as a Q0.16 fraction (col < 65536)
+inline uint16_t phaseOf(uint32_t col, uint32_t numCols) {
+  return (uint16_t)((col << 16) / numCols);
+}
+
+template <uint32_t N>
+class GradientLUT {
+  static_assert(N >= 2 && N <= 65536 && (N & (N - 1)) == 0, "GradientLUT size must be a power of 2");
+
+  public:
+    constexpr GradientLUT() : table() {}
+
+    constexpr GradientLUT(const Pixel* palette, uint32_t paletteSize) : table() {
+      bake(palette, paletteSize);
+    }
+
+    constexpr void bake(const Pixel* palette, uint32_t paletteSize) {
+      for (uint32_t i = 0; i < N; i++) {
+        // position in the palette as 16.16 fixed point
+        uint32_t pos = (uint32_t)(((uint64_t)i * paletteSize << 16) / N);
+        uint32_t index = pos >> 16;
+        uint32_t weight = pos & 0xffff; // towards the next color
+        const Pixel& a = palette[index];
+        const Pixel& b = palette[(index + 1) % paletteSize];
+        table[i] = { lerp16(b.blue, a.blue, weight),
+                     lerp16(b.green, a.green, weight),
+                     lerp16(b.red, a.red, weight) };
+      }
+    }
+
+    // phase 0-0xffff covers the whole palette once
+    Pixel at(uint16_t phase) const {
+      return table[phase >> shift()];
+    }
+
+    constexpr const Pixel& operator[](uint32_t i) const { return table[i]; }
+    static constexpr uint32_t size() { return N; }
+
+  private:
+    static constexpr uint32_t shift() {
+      uint32_t bits = 0;
+      while ((1u << bits) < N)
+        bits++;
+      return 16 - bits;
+    }
+
+    Pixel table[N];
+};
+
+// Same colors as rainbowAt(percent, rainbow12, 12), baked at compile time in gradient_lut.cpp
+// (one copy for the whole program rather than one per file that includes this header)
+extern const GradientLUT<256> rainbow12LUT;
+
+#endif // ifndef __GRADIENT_LUT_H
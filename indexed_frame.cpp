@@ -0,0 +1,57 @@
+#include "indexed_frame.h"
+#include <algorithm> // std::rotate
+#include <cstring>
+
+IndexedFrame::IndexedFrame(uint8_t* indices, uint32_t rings, uint32_t cols) {
+  idx = indices;
+  numRings = rings;
+  numCols = cols;
+  vecFill(Colors::Black, pal, PaletteEntries);
+}
+
+void IndexedFrame::fill(uint8_t i) {
+  memset(idx, i, numRings * numCols);
+}
+
+void IndexedFrame::fillColumn(uint32_t col, uint8_t i) {
+  memset(column(col), i, numRings);
+}
+
+void IndexedFrame::setColors(const Pixel* colors, uint32_t n, uint8_t first) {
+  if (n > PaletteEntries - first)
+    n = PaletteEntries - first;
+  vecFill(colors, pal + first, n);
+}
+
+void IndexedFrame::fade(uint16_t amt) {
+  vecFade(pal, pal, amt, PaletteEntries);
+}
+
+void IndexedFrame::brighten(uint16_t amt) {
+  vecBrighten(pal, pal, amt, PaletteEntries);
+}
+
+void IndexedFrame::scale(Scale16 s) {
+  vecScale(pal, pal, s, PaletteEntries);
+}
+
+void IndexedFrame::rotatePalette(uint8_t first, uint32_t count, int32_t steps) {
+  if (count > PaletteEntries - first)
+    count = PaletteEntries - first;
+  if (count < 2)
+    return;
+  int32_t shift = steps % (int32_t)count;
+  shift += shift < 0 ? count : 0;
+  if (shift == 0)
+    return;
+  // entry i moves to i + shift: the last shift entries wrap round to the front.
+  // In place, no copy of the palette on the stack
+  Pixel* range = pal + first;
+  std::rotate(range, range + count - shift, range + count);
+}
+
+void IndexedFrame::expandColumn(uint32_t col, Pixel* out) const {
+  const uint8_t* c = column(col);
+  for (uint32_t i = 0; i < numRings; i++)
+    out[i] = pal[c[i]];
+}
@@ -0,0 +1,70 @@
+#ifndef __INDEXED_FRAME_H
+#define __INDEXED_FRAME_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// 8-bit palette-indexed frame, for demos that only ever draw a handful of colors
+// Every pixel is one byte (laid out with indexAt) indexing a 256 entry palette of Pixels,
+// so the frame takes a sixth of the RAM. Whole-frame color changes work on the palette
+// instead of the pixels: fading, brightening or scaling is a 256 entry pass however big
+// the display is, and rotating part of the palette cycles the colors of everything drawn
+// with it (a rainbow wheel that spins without redrawing a pixel).
+// Pixels are only expanded by OutputStage, straight into the GS buffer.
+//
+//   static uint8_t indices[32 * 256];
+//   IndexedFrame frame(indices, 32, 256);
+//   frame.setColors(&rainbow12LUT[0], 256);
+//   for (uint32_t col = 0; col < 256; col++)
+//     frame.fillColumn(col, (uint8_t)col);
+//   ...every frame:
+//   frame.rotatePalette(0, 256, 1);
+//   output.bakePalette(frame, gsPalette);
+//   output.writeFrame(frame, gsPalette, gs);
+
+const uint32_t PaletteEntries = 256;
+
+class IndexedFrame {
+  public:
+    IndexedFrame(uint8_t* indices, uint32_t rings, uint32_t cols);
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    uint8_t* indices() { return idx; }
+    const uint8_t* indices() const { return idx; }
+    uint8_t* column(uint32_t col) { return idx + indexAt(numRings, col, 0); }
+    const uint8_t* column(uint32_t col) const { return idx + indexAt(numRings, col, 0); }
+
+    uint8_t get(uint32_t col, uint32_t ring) const { return idx[indexAt(numRings, col, ring)]; }
+    void set(uint32_t col, uint32_t ring, uint8_t i) { idx[indexAt(numRings, col, ring)] = i; }
+    Pixel color(uint32_t col, uint32_t ring) const { return pal[get(col, ring)]; }
+
+    void fill(uint8_t i);
+    void fillColumn(uint32_t col, uint8_t i);
+
+    //------ Palette ------//
+
+    Pixel* palette() { return pal; }
+    const Pixel* palette() const { return pal; }
+    void setColor(uint8_t i, Pixel p) { pal[i] = p; }
+    // colors into entries [first, first + n), n clipped to the palette
+    void setColors(const Pixel* colors, uint32_t n, uint8_t first = 0);
+
+    // vecFade/vecBrighten/vecScale on every palette entry, i.e. on the whole frame
+    void fade(uint16_t amt);
+    void brighten(uint16_t amt);
+    void scale(Scale16 s);
+    // Moves entries [first, first + count) up by steps (down if negative), wrapping
+    // within the range: pixels drawn with those entries cycle through their colors
+    void rotatePalette(uint8_t first, uint32_t count, int32_t steps);
+
+    // For code that needs real Pixels (rings of them), e.g. a Compositor layer
+    void expandColumn(uint32_t col, Pixel* out) const;
+
+  private:
+    Pixel pal[PaletteEntries];
+    uint8_t* idx;
+    uint32_t numRings;
+    uint32_t numCols;
+};
+
+#endif // ifndef __INDEXED_FRAME_H
@@ -0,0 +1,52 @@
+#include "input_queue.h"
+#include <Arduino.h> // Serial
+
+InputLatency::InputLatency(uint32_t budgetUs) {
+  budget = budgetUs;
+  reset();
+}
+
+void InputLatency::input(uint32_t timeUs) {
+  // when full the newest are dropped, so the stats lean towards the slow side
+  if (numPending < MaxPendingInputs)
+    pendingUs[numPending++] = timeUs;
+}
+
+void InputLatency::presented(uint32_t timeUs) {
+  for (uint32_t i = 0; i < numPending; i++) {
+    int32_t us = (int32_t)(timeUs - pendingUs[i]); // micros() wraps
+    uint32_t latency = us < 0 ? 0 : (uint32_t)us;
+    events++;
+    totalLatency += latency;
+    minLatency = latency < minLatency ? latency : minLatency;
+    maxLatency = latency > maxLatency ? latency : maxLatency;
+    if (budget && latency > budget)
+      lateEvents++;
+  }
+  numPending = 0;
+}
+
+void InputLatency::reset() {
+  numPending = 0;
+  events = 0;
+  lateEvents = 0;
+  minLatency = 0xffffffff;
+  maxLatency = 0;
+  totalLatency = 0;
+}
+
+void InputLatency::dump() const {
+  Serial.print("input latency: ");
+  Serial.print((unsigned long)events);
+  Serial.print(' ');
+  Serial.print((unsigned long)minUs());
+  Serial.print('/');
+  Serial.print((unsigned long)meanUs());
+  Serial.print('/');
+  Serial.print((unsigned long)maxUs());
+  Serial.print("us, ");
+  Serial.print((unsigned long)lateEvents);
+  Serial.print(" over ");
+  Serial.print((unsigned long)budget);
+  Serial.println("us");
+}
@@ -0,0 +1,147 @@
+#ifndef __INPUT_QUEUE_H
+#define __INPUT_QUEUE_H
+#include <atomic>
+#include <cstdint>
+
+// Timestamped key events from an input ISR to the demo loop
+// processKeypress(keys, diff) on its own only sees whatever the keys look like when the
+// loop gets round to polling them, so two edges between ticks get merged (or a quick
+// press and release is lost completely). The ISR pushes every change into a
+// single-producer/single-consumer ring instead, and the loop drains it in batches,
+// calling processKeypress once per edge in the order they happened.
+// The ISR only ever writes head, the loop only ever writes tail: no locks, no disabling
+// interrupts, just an acquire/release pair on each side.
+//
+//   KeyEventQueue<32> keyEvents;
+//   void keysChanged() { keyEvents.push(readKeys(), micros()); } // attachInterrupt
+//   ...every frame:
+//   keyEvents.drain(*demo, &latency);
+//   demo->tick();
+//   ...once the frame is on the LEDs:
+//   latency.presented(micros());
+
+struct KeyEvent {
+  uint32_t timeUs; // micros() when the ISR saw it
+  uint16_t keys;   // every key's state after the change
+  uint16_t diff;   // keys that changed
+};
+
+// Input-to-photon latency, the time from a key event to the first frame that can show
+// the demo's response. Drained events are held as pending until presented() is called
+// for a frame rendered after them.
+// budgetUs is the latency a response is allowed, e.g. one revolution: events that take
+// longer are counted as late.
+const uint32_t MaxPendingInputs = 32;
+
+class InputLatency {
+  public:
+    InputLatency(uint32_t budgetUs = 0);
+
+    void setBudget(uint32_t us) { budget = us; }
+    uint32_t budgetUs() const { return budget; }
+
+    // An event has been handed to the demo (drain() calls this)
+    void input(uint32_t timeUs);
+    // The frame rendered since the pending inputs is lit at timeUs. That can be in the
+    // future, e.g. the scheduler's deadline() for the column the response landed on
+    void presented(uint32_t timeUs);
+
+    uint32_t count() const { return events; }
+    uint32_t late() const { return lateEvents; }
+    uint32_t minUs() const { return events ? minLatency : 0; }
+    uint32_t maxUs() const { return maxLatency; }
+    uint32_t meanUs() const { return events ? (uint32_t)(totalLatency / events) : 0; }
+    uint32_t pending() const { return numPending; }
+    void reset();
+
+    // count min/mean/max us, late count and budget on one line
+    void dump() const;
+
+  private:
+    uint32_t pendingUs[MaxPendingInputs];
+    uint32_t numPending;
+    uint32_t budget;
+    uint32_t events;
+    uint32_t lateEvents;
+    uint32_t minLatency;
+    uint32_t maxLatency;
+    uint64_t totalLatency;
+};
+
+template <uint32_t Capacity = 32>
+class KeyEventQueue {
+  static_assert(Capacity && (Capacity & (Capacity - 1)) == 0, "KeyEventQueue capacity must be a power of 2");
+
+  public:
+    KeyEventQueue() {
+      head.store(0);
+      tail.store(0);
+      lastKeys = 0;
+      overflows.store(0);
+    }
+
+    //------ Producer side (ISR) ------//
+
+    // Queues the change from the last pushed state, nothing happens if keys didn't change.
+    // False if the queue is full; the event is dropped, but the next one still carries
+    // every key that changed since the loop last heard about it
+    bool push(uint16_t keys, uint32_t timeUs) {
+      uint16_t diff = keys ^ lastKeys;
+      if (!diff)
+        return true;
+      uint32_t h = head.load(std::memory_order_relaxed);
+      if (h - tail.load(std::memory_order_acquire) == Capacity) {
+        overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return false;
+      }
+      events[h & (Capacity - 1)] = { timeUs, keys, diff };
+      head.store(h + 1, std::memory_order_release);
+      lastKeys = keys;
+      return true;
+    }
+
+    //------ Consumer side (demo loop) ------//
+
+    bool pop(KeyEvent& e) {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      if (head.load(std::memory_order_acquire) == t)
+        return false;
+      e = events[t & (Capacity - 1)];
+      tail.store(t + 1, std::memory_order_release);
+      return true;
+    }
+
+    // Feeds up to maxEvents events to target.processKeypress(keys, diff) one by one,
+    // oldest first. Target is anything with processKeypress: a Demo, a Transition, a
+    // DemoRegistry. Returns how many were handled
+    template <typename Target>
+    uint32_t drain(Target& target, InputLatency* latency = nullptr, uint32_t maxEvents = Capacity) {
+      uint32_t t = tail.load(std::memory_order_relaxed);
+      uint32_t h = head.load(std::memory_order_acquire);
+      uint32_t n = h - t < maxEvents ? h - t : maxEvents;
+      for (uint32_t i = 0; i < n; i++) {
+        const KeyEvent& e = events[(t + i) & (Capacity - 1)];
+        target.processKeypress(e.keys, e.diff);
+        if (latency)
+          latency->input(e.timeUs);
+      }
+      tail.store(t + n, std::memory_order_release); // one release for the whole batch
+      return n;
+    }
+
+    //------ Either side ------//
+
+    uint32_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    bool empty() const { return size() == 0; }
+    uint32_t capacity() const { return Capacity; }
+    uint32_t dropped() const { return overflows.load(std::memory_order_relaxed); }
+
+  private:
+    KeyEvent events[Capacity];
+    std::atomic<uint32_t> head; // next slot to write, producer only (free running)
+    std::atomic<uint32_t> tail; // next slot to read, consumer only (free running)
+    uint16_t lastKeys;          // producer only
+    std::atomic<uint32_t> overflows;
+};
+
+#endif // ifndef __INPUT_QUEUE_H
@@ -0,0 +1,148 @@
+#ifndef __OSCILLATORS_H
+#define __OSCILLATORS_H
+#include <cstdint>
+
+// Integer oscillators: a 32-bit phase accumulator per wave (0 - 2^32 is one cycle)
+// advanced once per frame by the time that passed, instead of beat16()/beatSine16()
+// re-reading micros() and doing float math on every call. Evaluating a wave is a
+// table read from a quarter-wave Q15 sine table.
+//
+//   OscillatorClock clock;
+//   Oscillator wobble(0.5);            // 0.5 Hz
+//   ...every frame:
+//   clock.tick(micros());
+//   wobble.advance(clock);
+//   uint16_t brightness = wobble.sine(); // 0 - 0xffff
+
+// sin(0 .. pi/2) in Q15, 256 steps plus the end point
+const uint32_t QuarterSineBits = 8;
+extern const int16_t quarterSineQ15[(1 << QuarterSineBits) + 1];
+
+// sin of a 32-bit phase as Q15 (-32767 - 32767)
+inline int16_t sinQ15(uint32_t phase) {
+  uint32_t quadrant = phase >> 30;
+  uint32_t index = (phase >> (30 - QuarterSineBits)) & ((1 << QuarterSineBits) - 1);
+  if (quadrant & 1)
+    index = (1 << QuarterSineBits) - index; // falling half of each half cycle
+  int16_t v = quarterSineQ15[index];
+  return quadrant & 2 ? -v : v;
+}
+
+// Unit waves, 0 - 0xffff like beatSine16Unit()
+inline uint16_t sine16(uint32_t phase) {
+  return (uint16_t)(sinQ15(phase) + 32768);
+}
+
+inline uint16_t triangle16(uint32_t phase) {
+  uint32_t t = phase >> 15; // 17 bits, up then down
+  return t & 0x10000 ? (uint16_t)~t : (uint16_t)t;
+}
+
+inline uint16_t saw16(uint32_t phase) {
+  return phase >> 16;
+}
+
+// Maps a unit wave onto lo - hi, integer version of beatSine16()'s range scaling
+// hi < lo is fine too, the wave is just flipped (unit 0 is still lo)
+inline uint16_t scaleRange16(uint16_t unit, uint16_t lo, uint16_t hi) {
+  if (hi < lo)
+    return lo - (uint16_t)(((uint32_t)(lo - hi) * unit) >> 16);
+  return lo + (uint16_t)(((uint32_t)(hi - lo) * unit) >> 16);
+}
+
+// Phase step per microsecond for a frequency, Q24.8
+// Frequencies are clamped to 0 - ~3.9kHz (the most a uint32_t rate holds), negative
+// and NaN frequencies stop the oscillator
+const float MaxOscillatorHz = 4294967295.0f / (4294.967296f * 256.0f);
+
+inline uint32_t phaseRate(float hz) {
+  if (!(hz > 0.0f))
+    return 0;
+  if (hz >= MaxOscillatorHz)
+    return 0xffffffff;
+  return (uint32_t)(hz * 4294.967296f * 256.0f);
+}
+
+// Shared frame timestamp, tick() once per frame and advance every oscillator with it
+class OscillatorClock {
+  public:
+    OscillatorClock();
+    void tick(uint32_t nowUs);
+    uint32_t nowUs() const { return lastUs; }
+    uint32_t deltaUs() const { return dtUs; }
+
+  private:
+    uint32_t lastUs;
+    uint32_t dtUs;
+    bool started;
+};
+
+class Oscillator {
+  public:
+    Oscillator();
+    Oscillator(float hz, uint32_t startPhase = 0);
+
+    void setFrequency(float hz) { rate = phaseRate(hz); }
+    void advance(uint32_t dtUs) { phase += (uint32_t)(((uint64_t)rate * dtUs) >> 8); }
+    void advance(const OscillatorClock& clock) { advance(clock.deltaUs()); }
+
+    uint16_t sine() const { return sine16(phase); }
+    uint16_t triangle() const { return triangle16(phase); }
+    uint16_t saw() const { return saw16(phase); }
+
+    uint32_t phase;
+    uint32_t rate; // see phaseRate()
+};
+
+// N oscillators stored as arrays, advanced and evaluated in one loop each,
+// e.g. one per ring or per column
+template <uint32_t N>
+class OscillatorBank {
+  public:
+    OscillatorBank() {
+      for (uint32_t i = 0; i < N; i++) {
+        phases[i] = 0;
+        rates[i] = 0;
+      }
+    }
+
+    void set(uint32_t i, float hz, uint32_t startPhase = 0) {
+      rates[i] = phaseRate(hz);
+      phases[i] = startPhase;
+    }
+
+    // Same frequency for all, phases spread evenly over one cycle (a travelling wave)
+    void spread(float hz) {
+      uint32_t rate = phaseRate(hz);
+      for (uint32_t i = 0; i < N; i++) {
+        rates[i] = rate;
+        phases[i] = (uint32_t)(((uint64_t)i << 32) / N);
+      }
+    }
+
+    void advance(uint32_t dtUs) {
+      for (uint32_t i = 0; i < N; i++)
+        phases[i] += (uint32_t)(((uint64_t)rates[i] * dtUs) >> 8);
+    }
+    void advance(const OscillatorClock& clock) { advance(clock.deltaUs()); }
+
+    void sine(uint16_t* out) const {
+      for (uint32_t i = 0; i < N; i++)
+        out[i] = sine16(phases[i]);
+    }
+    void triangle(uint16_t* out) const {
+      for (uint32_t i = 0; i < N; i++)
+        out[i] = triangle16(phases[i]);
+    }
+    void saw(uint16_t* out) const {
+      for (uint32_t i = 0; i < N; i++)
+        out[i] = saw16(phases[i]);
+    }
+
+    static constexpr uint32_t size() { return N; }
+
+    uint32_t phases[N];
+    uint32_t rates[N];
+};
+
+#endif // ifndef __OSCILLATORS_H
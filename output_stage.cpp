@@ -0,0 +1,188 @@
+#include "output_stage.h"
+#include <math.h> // powf
+
+GammaLUT::GammaLUT() {
+  build(1.0f);
+}
+
+GammaLUT::GammaLUT(float g) {
+  build(g);
+}
+
+void GammaLUT::build(float g) {
+  for (uint32_t i = 0; i <= 256; i++) {
+    float x = i / 256.0f;
+    float y = powf(x, g) * 65535.0f + 0.5f;
+    table[i] = y > 65535.0f ? 0xffff : (uint16_t)y;
+  }
+}
+
+OutputStage::OutputStage(ChannelOrder order) {
+  offsets = channelOffsets(order);
+  brightness = ScaleOne;
+  gamma = nullptr;
+  q15Input = false;
+  reverseRings = false;
+}
+
+// The whole per-channel pipeline, flags fixed per instantiation so the loop has no branches
+template <bool Q15, bool Gamma>
+static inline uint16_t outputValue(uint16_t v, Scale16 brightness, const GammaLUT* gamma) {
+  if (Q15) // 0x7fff -> 0xffff, anything above saturates
+    v = v > 0x7fff ? 0xffff : (uint16_t)((v << 1) | (v >> 14));
+  v = qmult16(v, brightness);
+  if (Gamma)
+    v = gamma->apply(v);
+  return v;
+}
+
+// Fractional rotation: blend each channel with the same ring of the next column,
+// which sits next elements further on (lerp weight out of 0x10000)
+struct ColumnBlend {
+  int32_t next;
+  uint32_t weight;
+};
+
+// S is the source channel type, Pixel8 channels are widened to 16 bits here and
+// nowhere else
+template <bool Lerp, typename S>
+static inline uint16_t sampleValue(const S* src, ColumnBlend blend) {
+  if (Lerp)
+    return widen16((S)lerp16(src[blend.next], src[0], blend.weight));
+  return widen16(src[0]);
+}
+
+// InOrder: the channels come in wire order, so each LED is 3 entries straight through,
+// the offsets are constants instead of a per-pixel swizzle
+template <bool Q15, bool Gamma, bool Lerp, bool InOrder, typename S>
+static void writeLeds(const S* blue, const S* green, const S* red, uint32_t srcStride,
+                      ColumnBlend blend, uint32_t rings, uint16_t* gs, int32_t gsStride, ChannelOffsets o,
+                      Scale16 brightness, const GammaLUT* gamma) {
+  for (uint32_t i = 0; i < rings; i++) {
+    uint32_t s = i * srcStride;
+    gs[InOrder ? 0 : o.blue] = outputValue<Q15, Gamma>(sampleValue<Lerp>(blue + s, blend), brightness, gamma);
+    gs[InOrder ? 1 : o.green] = outputValue<Q15, Gamma>(sampleValue<Lerp>(green + s, blend), brightness, gamma);
+    gs[InOrder ? 2 : o.red] = outputValue<Q15, Gamma>(sampleValue<Lerp>(red + s, blend), brightness, gamma);
+    gs += gsStride;
+  }
+}
+
+template <bool Lerp, bool InOrder, typename S>
+static void writeLedsFor(const S* blue, const S* green, const S* red, uint32_t srcStride,
+                         ColumnBlend blend, uint32_t rings, uint16_t* gs, int32_t gsStride, ChannelOffsets o,
+                         Scale16 brightness, const GammaLUT* gamma, bool q15) {
+  if (q15) {
+    if (gamma)
+      writeLeds<true, true, Lerp, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness,
+                                          gamma);
+    else
+      writeLeds<true, false, Lerp, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness,
+                                          gamma);
+  } else {
+    if (gamma)
+      writeLeds<false, true, Lerp, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness,
+                                          gamma);
+    else
+      writeLeds<false, false, Lerp, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness,
+                                          gamma);
+  }
+}
+
+// Channels come in as three strided arrays, so Pixel*, Pixel8* and FrameBuffer share the pass
+template <bool InOrder = false, typename S>
+static void writeChannels(const S* blue, const S* green, const S* red, uint32_t srcStride,
+                          ColumnBlend blend, uint32_t rings, uint16_t* gs, bool reverse, ChannelOffsets o,
+                          Scale16 brightness, const GammaLUT* gamma, bool q15) {
+  int32_t gsStride = 3;
+  if (reverse) {
+    gs += 3 * (rings - 1);
+    gsStride = -3;
+  }
+  q15 = q15 && sizeof(S) == 2; // 8-bit channels never went through Q15 math
+  if (blend.weight)
+    writeLedsFor<true, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness, gamma, q15);
+  else
+    writeLedsFor<false, InOrder>(blue, green, red, srcStride, blend, rings, gs, gsStride, o, brightness, gamma, q15);
+}
+
+// PixelT arrays are stored in Order: when the wire order is the same, channel i goes to
+// GS entry i. Otherwise the offsets put them in place
+template <typename T, ChannelOrder Order>
+static void writePixels(const PixelT<T, Order>* pixels, ColumnBlend blend, uint32_t rings, uint16_t* gs,
+                        bool reverse, ChannelOffsets o, Scale16 brightness, const GammaLUT* gamma, bool q15) {
+  const T* p = (const T*)pixels;
+  constexpr ChannelOffsets stored = channelOffsets(Order);
+  if (o == stored)
+    writeChannels<true>(p, p + 1, p + 2, 3, blend, rings, gs, reverse, o, brightness, gamma, q15);
+  else
+    writeChannels(p + stored.blue, p + stored.green, p + stored.red, 3, blend, rings, gs, reverse, o, brightness,
+                  gamma, q15);
+}
+
+void OutputStage::writeColumn(const Pixel* column, uint32_t rings, uint16_t* gs) const {
+  TGRAPHICS_PROBE("OutputStage::writeColumn");
+  writePixels(column, { 0, 0 }, rings, gs, reverseRings, offsets, brightness, gamma, q15Input);
+}
+
+void OutputStage::writeColumn(const Pixel8* column, uint32_t rings, uint16_t* gs) const {
+  TGRAPHICS_PROBE("OutputStage::writeColumn");
+  writePixels(column, { 0, 0 }, rings, gs, reverseRings, offsets, brightness, gamma, q15Input);
+}
+
+void OutputStage::writeColumn(const FrameBuffer& frame, uint32_t col, uint16_t* gs) const {
+  TGRAPHICS_PROBE("OutputStage::writeColumn");
+  uint32_t i = frame.index(col, 0);
+  writeChannels(frame.plane(Channel::Blue) + i, frame.plane(Channel::Green) + i, frame.plane(Channel::Red) + i, 1,
+                { 0, 0 }, frame.rings(), gs, reverseRings, offsets, brightness, gamma, q15Input);
+}
+
+void OutputStage::writeColumn(const RotatedView& view, uint32_t col, uint16_t* gs) const {
+  TGRAPHICS_PROBE("OutputStage::writeColumn");
+  const Pixel* p = view.column(col);
+  ColumnBlend blend = { (int32_t)(3 * (view.nextColumn(col) - p)), view.fraction() };
+  writePixels(p, blend, view.rings(), gs, reverseRings, offsets, brightness, gamma, q15Input);
+}
+
+void OutputStage::writeFrame(const RotatedView& view, uint16_t* gs) const {
+  for (uint32_t col = 0; col < view.cols(); col++)
+    writeColumn(view, col, gs + col * 3 * view.rings());
+}
+
+void OutputStage::writeFrame(const Pixel* frame, uint32_t rings, uint32_t cols, uint16_t* gs) const {
+  for (uint32_t col = 0; col < cols; col++)
+    writeColumn(frame + indexAt(rings, col, 0), rings, gs + col * 3 * rings);
+}
+
+void OutputStage::writeFrame(const Pixel8* frame, uint32_t rings, uint32_t cols, uint16_t* gs) const {
+  for (uint32_t col = 0; col < cols; col++)
+    writeColumn(frame + indexAt(rings, col, 0), rings, gs + col * 3 * rings);
+}
+
+void OutputStage::bakePalette(const IndexedFrame& frame, GsPalette& out) const {
+  // the palette goes through the same pass as a 256 LED column, never reversed
+  writePixels(frame.palette(), { 0, 0 }, PaletteEntries, &out.entries[0][0], false, offsets, brightness, gamma,
+              q15Input);
+}
+
+void OutputStage::writeColumn(const IndexedFrame& frame, uint32_t col, const GsPalette& palette, uint16_t* gs) const {
+  TGRAPHICS_PROBE("OutputStage::writeColumn");
+  const uint8_t* column = frame.column(col);
+  uint32_t rings = frame.rings();
+  int32_t gsStride = 3;
+  if (reverseRings) {
+    gs += 3 * (rings - 1);
+    gsStride = -3;
+  }
+  for (uint32_t i = 0; i < rings; i++) {
+    const uint16_t* e = palette.entries[column[i]];
+    gs[0] = e[0];
+    gs[1] = e[1];
+    gs[2] = e[2];
+    gs += gsStride;
+  }
+}
+
+void OutputStage::writeFrame(const IndexedFrame& frame, const GsPalette& palette, uint16_t* gs) const {
+  for (uint32_t col = 0; col < frame.cols(); col++)
+    writeColumn(frame, col, palette, gs + col * 3 * frame.rings());
+}
@@ -0,0 +1,78 @@
+#ifndef __OUTPUT_STAGE_H
+#define __OUTPUT_STAGE_H
+#include "tgraphics.h"
+#include "framebuffer.h"
+#include "rotation_view.h"
+#include "indexed_frame.h"
+#include <cstdint>
+
+// Final Pixel -> TLC5948 grayscale (GS) buffer pass
+// Brightness, gamma, the Q15 bit fix-up (see the note at the top of tgraphics.h) and
+// the channel order the driver expects all happen in one pass over the frame, instead
+// of a full-buffer pass for each. Each LED takes 3 consecutive GS entries.
+// Pixels stored in the same order as the wire (NativeOrder, see TGRAPHICS_CHANNEL_ORDER)
+// go through without any reordering.
+
+// 16-bit gamma curve, 256 segments with linear interpolation in between
+class GammaLUT {
+  public:
+    GammaLUT(); // linear
+    GammaLUT(float gamma);
+    void build(float gamma);
+
+    uint16_t apply(uint16_t v) const {
+      uint32_t i = v >> 8;
+      uint32_t lo = table[i], hi = table[i + 1];
+      return lo + (((hi - lo) * (v & 0xff)) >> 8);
+    }
+
+  private:
+    uint16_t table[257];
+};
+
+// GS values of every palette entry of an IndexedFrame, in wire order with brightness and
+// gamma applied (OutputStage::bakePalette), so an indexed LED is a 3 entry copy
+struct GsPalette {
+  uint16_t entries[PaletteEntries][3];
+};
+
+class OutputStage {
+  public:
+    OutputStage(ChannelOrder order = NativeOrder);
+
+    void setOrder(ChannelOrder order) { offsets = channelOffsets(order); }
+    // e.g. toScale16(255.0) to stretch the 8-bit Colors:: onto the 16-bit PWM range.
+    // Pixel8 frames are widened (0xff -> 0xffff) before this, so leave them at ScaleOne
+    void setBrightness(Scale16 scale) { brightness = scale; }
+    void setGamma(const GammaLUT* lut) { gamma = lut; } // nullptr for linear
+    // Input came out of Q15 math (max 0x7fff), shift the lost bit back in. Pixel only
+    void setQ15Input(bool q15) { q15Input = q15; }
+    // Ring 0 is the last LED in the GS buffer instead of the first
+    void setReverseRings(bool reverse) { reverseRings = reverse; }
+
+    // One column (rings LEDs) into gs, 3 * rings entries
+    void writeColumn(const Pixel* column, uint32_t rings, uint16_t* gs) const;
+    void writeColumn(const Pixel8* column, uint32_t rings, uint16_t* gs) const;
+    void writeColumn(const FrameBuffer& frame, uint32_t col, uint16_t* gs) const;
+    // View column col, blended with the next one when the rotation has a fraction
+    void writeColumn(const RotatedView& view, uint32_t col, uint16_t* gs) const;
+    // Every column, back to back (column col starts at gs + col * 3 * rings)
+    void writeFrame(const Pixel* frame, uint32_t rings, uint32_t cols, uint16_t* gs) const;
+    void writeFrame(const Pixel8* frame, uint32_t rings, uint32_t cols, uint16_t* gs) const;
+    void writeFrame(const RotatedView& view, uint16_t* gs) const;
+
+    // Indexed frames: bake the palette once per frame (after any palette change, or a
+    // change to the settings above), then every LED is a lookup
+    void bakePalette(const IndexedFrame& frame, GsPalette& out) const;
+    void writeColumn(const IndexedFrame& frame, uint32_t col, const GsPalette& palette, uint16_t* gs) const;
+    void writeFrame(const IndexedFrame& frame, const GsPalette& palette, uint16_t* gs) const;
+
+  private:
+    ChannelOffsets offsets;
+    Scale16 brightness;
+    const GammaLUT* gamma;
+    bool q15Input;
+    bool reverseRings;
+};
+
+#endif // ifndef __OUTPUT_STAGE_H
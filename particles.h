@@ -0,0 +1,176 @@
+#ifndef __PARTICLES_H
+#define __PARTICLES_H
+#include "tgraphics.h"
+#include "oscillators.h" // sinQ15 for burst directions
+#include "column_scheduler.h" // ColumnBitmap
+#include <cstdint>
+
+// Fixed-capacity particle pool (no heap), stored as structure of arrays
+// Positions are 16.16 fixed point in column/ring space: columns wrap around the sweep,
+// rings are bounded by the center and the outer edge. Velocities are 16.16 per second.
+// Every particle has an energy that counts down from full to 0 over its life and scales
+// its color when splatted. Dead particles are swap-removed, so the live ones stay packed
+// at the front of the arrays and every loop runs over exactly size() entries.
+//
+//   ParticlePool<256> sparks(rings, cols);
+//   ...processKeypress:
+//   sparks.burst(toFixed16(col), toFixed16(ring), 24, toFixed16(8.0), Colors::Orange, 1000);
+//   ...every frame:
+//   sparks.update(dtUs);
+//   sparks.splat(pixels);
+
+// What happens to particles that leave the rings
+enum class RingEdge : uint8_t {
+  Kill,
+  Bounce,
+};
+
+template <uint32_t Capacity>
+class ParticlePool {
+  public:
+    ParticlePool(uint32_t rings, uint32_t cols) {
+      setBounds(rings, cols);
+      gravity = 0;
+      edge = RingEdge::Kill;
+      count = 0;
+    }
+
+    void setBounds(uint32_t rings, uint32_t cols) {
+      numRings = rings;
+      numCols = cols;
+    }
+    // 16.16 rings per second^2, positive pulls towards the outer ring
+    void setGravity(int32_t ringsPerS2) { gravity = ringsPerS2; }
+    void setRingEdge(RingEdge e) { edge = e; }
+
+    uint32_t size() const { return count; }
+    uint32_t capacity() const { return Capacity; }
+    bool full() const { return count == Capacity; }
+    void clear() { count = 0; }
+
+    // Spawn hooks, cheap enough to call from processKeypress. c wraps around the sweep,
+    // false when the pool is full or r is off the rings
+    bool spawn(int32_t c, int32_t r, int32_t vc, int32_t vr, Pixel color, uint32_t lifeMs) {
+      int32_t colSpan = (int32_t)(numCols << 16);
+      if (count == Capacity || colSpan == 0 || r < 0 || r >= (int32_t)(numRings << 16))
+        return false;
+      c %= colSpan;
+      uint32_t i = count++;
+      col[i] = c < 0 ? c + colSpan : c;
+      ring[i] = r;
+      vCol[i] = vc;
+      vRing[i] = vr;
+      colors[i] = color;
+      energy[i] = 0xffffffff;
+      decay[i] = lifeMs ? (uint32_t)(0xffffffffULL / ((uint64_t)lifeMs * 1000)) : 0xffffffff;
+      return true;
+    }
+
+    // num particles flying out of (c, r) at speed, evenly spread around a circle.
+    // Returns how many fit in the pool
+    uint32_t burst(int32_t c, int32_t r, uint32_t num, int32_t speed, Pixel color, uint32_t lifeMs) {
+      uint32_t step = num ? (uint32_t)(0x100000000ULL / num) : 0;
+      uint32_t phase = 0;
+      for (uint32_t i = 0; i < num; i++, phase += step) {
+        int32_t vc = (int32_t)(((int64_t)speed * sinQ15(phase + 0x40000000)) >> 15); // cos
+        int32_t vr = (int32_t)(((int64_t)speed * sinQ15(phase)) >> 15);
+        if (!spawn(c, r, vc, vr, color, lifeMs))
+          return i;
+      }
+      return num;
+    }
+
+    // Integrate everything by dtUs (keep it under a second), then drop the dead
+    void update(uint32_t dtUs) {
+      TGRAPHICS_PROBE("ParticlePool::update");
+      int64_t dt = (int64_t)dtUs * 4295; // seconds in Q0.32
+      int32_t dv = (int32_t)((gravity * dt) >> 32);
+      int32_t colSpan = (int32_t)(numCols << 16);
+      for (uint32_t i = 0; i < count; i++) {
+        vRing[i] += dv;
+        int32_t c = col[i] + (int32_t)((vCol[i] * dt) >> 32);
+        c += c < 0 ? colSpan : 0;
+        col[i] = c >= colSpan ? c - colSpan : c;
+        ring[i] += (int32_t)((vRing[i] * dt) >> 32);
+        uint64_t spent = (uint64_t)decay[i] * dtUs;
+        energy[i] = spent >= energy[i] ? 0 : energy[i] - (uint32_t)spent;
+      }
+      if (edge == RingEdge::Bounce)
+        bounce();
+      compact();
+    }
+
+    // Additive (saturating) blend into a Pixel buffer laid out with indexAt
+    // Particles outside the current bounds (e.g. after setBounds() shrank them) are skipped
+    void splat(Pixel* pixels) const {
+      TGRAPHICS_PROBE("ParticlePool::splat");
+      for (uint32_t i = 0; i < count; i++) {
+        uint32_t c = (uint32_t)col[i] >> 16, r = (uint32_t)ring[i] >> 16;
+        if (c >= numCols || r >= numRings)
+          continue;
+        uint32_t idx = indexAt(numRings, c, r);
+        Scale16 s = { (uint16_t)(energy[i] >> 24) }; // 0 - 0xff, just under 1.0
+        pixels[idx] = pixels[idx] + colors[i] * s;
+      }
+    }
+
+    // Columns holding at least one particle, e.g. for Compositor::setCoverage
+    void markColumns(ColumnBitmap& columns) const {
+      for (uint32_t i = 0; i < count; i++) {
+        uint32_t c = (uint32_t)col[i] >> 16;
+        if (c < numCols)
+          columns.set(c);
+      }
+    }
+
+    // Structure of arrays, [0, size()) are live
+    int32_t col[Capacity];   // 16.16 columns
+    int32_t ring[Capacity];  // 16.16 rings
+    int32_t vCol[Capacity];  // 16.16 columns per second
+    int32_t vRing[Capacity]; // 16.16 rings per second
+    Pixel colors[Capacity];
+    uint32_t energy[Capacity]; // 0xffffffff at spawn, dead at 0
+    uint32_t decay[Capacity];  // energy lost per us
+
+  private:
+    void bounce() {
+      int32_t ringSpan = (int32_t)(numRings << 16);
+      for (uint32_t i = 0; i < count; i++) {
+        if (ring[i] < 0) {
+          ring[i] = -ring[i];
+          vRing[i] = -vRing[i];
+        } else if (ring[i] >= ringSpan) {
+          ring[i] = 2 * ringSpan - 1 - ring[i];
+          vRing[i] = -vRing[i];
+        }
+      }
+    }
+
+    // Swap-remove the dead (out of energy, or off the rings) with the last live particle
+    void compact() {
+      int32_t ringSpan = (int32_t)(numRings << 16);
+      uint32_t i = 0;
+      while (i < count) {
+        if (energy[i] != 0 && ring[i] >= 0 && ring[i] < ringSpan) {
+          i++;
+          continue;
+        }
+        uint32_t last = --count;
+        col[i] = col[last];
+        ring[i] = ring[last];
+        vCol[i] = vCol[last];
+        vRing[i] = vRing[last];
+        colors[i] = colors[last];
+        energy[i] = energy[last];
+        decay[i] = decay[last];
+      }
+    }
+
+    uint32_t count;
+    uint32_t numRings;
+    uint32_t numCols;
+    int64_t gravity;
+    RingEdge edge;
+};
+
+#endif // ifndef __PARTICLES_H
@@ -0,0 +1,161 @@
+#include "polar_map.h"
+#include <math.h> // sinf, cosf, atan2f, sqrtf
+
+static const float TwoPi = 6.28318531f;
+
+// Splits a source coordinate into a cell and a weight towards the next one (out of 256).
+// The cell is kept at most size - 2 so the +1 neighbour always exists.
+static void splitCoord(float v, uint32_t size, uint32_t& cell, uint16_t& frac) {
+  if (v <= 0.0f || size < 2) {
+    cell = 0;
+    frac = 0;
+    return;
+  }
+  if (v >= (float)(size - 1)) {
+    cell = size - 2;
+    frac = 256;
+    return;
+  }
+  cell = (uint32_t)v;
+  frac = (uint16_t)((v - cell) * 256.0f + 0.5f);
+}
+
+static uint32_t nearestCoord(float v, uint32_t size) {
+  if (v <= 0.0f)
+    return 0;
+  uint32_t i = (uint32_t)(v + 0.5f);
+  return i >= size ? size - 1 : i;
+}
+
+// The 2x2 blend both directions share, the neighbours are passed in as offsets.
+// The four weights sum to 0x10000, so a full-scale sum still fits in 32 bits
+static inline Pixel bilinear(const Pixel* src, int32_t nextX, int32_t nextY, const PolarTap& t) {
+  uint32_t w11 = (uint32_t)t.fx * t.fy;
+  uint32_t w01 = ((uint32_t)t.fx << 8) - w11;
+  uint32_t w10 = ((uint32_t)t.fy << 8) - w11;
+  uint32_t w00 = 0x10000 - w01 - w10 - w11;
+  const Pixel& a = src[0];
+  const Pixel& b = src[nextX];
+  const Pixel& c = src[nextY];
+  const Pixel& d = src[nextY + nextX];
+  return { (uint16_t)((a.blue * w00 + b.blue * w01 + c.blue * w10 + d.blue * w11) >> 16),
+           (uint16_t)((a.green * w00 + b.green * w01 + c.green * w10 + d.green * w11) >> 16),
+           (uint16_t)((a.red * w00 + b.red * w01 + c.red * w10 + d.red * w11) >> 16) };
+}
+
+//##################
+// XY -> polar
+//##################
+
+PolarMap::PolarMap(PolarTap* storage, uint32_t rings, uint32_t cols) {
+  taps = storage;
+  numRings = rings;
+  numCols = cols;
+  width = 0;
+  sampling = Sampling::Nearest;
+}
+
+void PolarMap::build(uint32_t w, uint32_t h, Sampling s) {
+  width = w;
+  sampling = (w < 2 || h < 2) ? Sampling::Nearest : s;
+  float cx = (w - 1) * 0.5f;
+  float cy = (h - 1) * 0.5f;
+  float ringSize = (w < h ? w : h) * 0.5f / numRings;
+  for (uint32_t col = 0; col < numCols; col++) {
+    float angle = TwoPi * col / numCols;
+    float c = cosf(angle), sn = sinf(angle);
+    for (uint32_t ring = 0; ring < numRings; ring++) {
+      float radius = (ring + 0.5f) * ringSize;
+      float x = cx + radius * c, y = cy + radius * sn;
+      PolarTap& t = taps[indexAt(numRings, col, ring)];
+      if (sampling == Sampling::Bilinear) {
+        uint32_t ix, iy;
+        splitCoord(x, w, ix, t.fx);
+        splitCoord(y, h, iy, t.fy);
+        t.src = iy * w + ix;
+      } else {
+        t.src = nearestCoord(y, h) * w + nearestCoord(x, w);
+        t.fx = t.fy = 0;
+      }
+    }
+  }
+}
+
+void PolarMap::blit(const Pixel* image, Pixel* polar) const {
+  TGRAPHICS_PROBE("PolarMap::blit");
+  uint32_t n = numRings * numCols;
+  if (sampling == Sampling::Nearest) {
+    for (uint32_t i = 0; i < n; i++)
+      polar[i] = image[taps[i].src];
+    return;
+  }
+  for (uint32_t i = 0; i < n; i++)
+    polar[i] = bilinear(image + taps[i].src, 1, (int32_t)width, taps[i]);
+}
+
+//##################
+// polar -> XY
+//##################
+
+CartesianMap::CartesianMap(PolarTap* storage, uint32_t w, uint32_t h) {
+  taps = storage;
+  imgWidth = w;
+  imgHeight = h;
+  numRings = 0;
+  numCols = 0;
+  sampling = Sampling::Nearest;
+}
+
+void CartesianMap::build(uint32_t rings, uint32_t cols, Sampling s) {
+  numRings = rings;
+  numCols = cols;
+  sampling = rings < 2 ? Sampling::Nearest : s;
+  float cx = (imgWidth - 1) * 0.5f;
+  float cy = (imgHeight - 1) * 0.5f;
+  float ringSize = (imgWidth < imgHeight ? imgWidth : imgHeight) * 0.5f / rings;
+  for (uint32_t y = 0; y < imgHeight; y++) {
+    for (uint32_t x = 0; x < imgWidth; x++) {
+      PolarTap& t = taps[y * imgWidth + x];
+      float dx = x - cx, dy = y - cy;
+      float ringPos = sqrtf(dx * dx + dy * dy) / ringSize - 0.5f;
+      if (ringPos > rings - 0.5f) { // outside the disc
+        t.src = NoSource;
+        t.fx = t.fy = 0;
+        continue;
+      }
+      float colPos = atan2f(dy, dx) / TwoPi * cols;
+      if (colPos < 0.0f)
+        colPos += cols;
+      if (sampling == Sampling::Bilinear) {
+        uint32_t ring, col = (uint32_t)colPos;
+        splitCoord(ringPos, rings, ring, t.fx);
+        t.fy = (uint16_t)((colPos - col) * 256.0f + 0.5f);
+        if (col >= cols) // colPos rounded up to cols
+          col -= cols;
+        t.src = indexAt(rings, col, ring);
+      } else {
+        uint32_t col = (uint32_t)(colPos + 0.5f);
+        t.src = indexAt(rings, col >= cols ? col - cols : col, nearestCoord(ringPos, rings));
+        t.fx = t.fy = 0;
+      }
+    }
+  }
+}
+
+void CartesianMap::blit(const Pixel* polar, Pixel* image) const {
+  TGRAPHICS_PROBE("CartesianMap::blit");
+  uint32_t n = imgWidth * imgHeight;
+  uint32_t total = numRings * numCols;
+  for (uint32_t i = 0; i < n; i++) {
+    const PolarTap& t = taps[i];
+    if (t.src == NoSource) {
+      image[i] = Colors::Black;
+    } else if (sampling == Sampling::Nearest) {
+      image[i] = polar[t.src];
+    } else {
+      // the next column wraps back to column 0 at the end of the sweep
+      int32_t nextCol = t.src + numRings < total ? (int32_t)numRings : (int32_t)numRings - (int32_t)total;
+      image[i] = bilinear(polar + t.src, 1, nextCol, t);
+    }
+  }
+}
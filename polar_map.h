@@ -0,0 +1,95 @@
+#ifndef __POLAR_MAP_H
+#define __POLAR_MAP_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Polar <-> Cartesian resampling through precomputed tables
+// build() does all the trig once (at setup), blit() is then a single table-driven pass
+// with integer weights, so images/text/sprites drawn in XY can go onto the rings.
+
+/*-- Geometry:
+
+    Column col is the spoke at angle 2*pi*col/cols, starting at +x and turning towards +y
+    (clockwise on a y-down image). Ring 0 is the innermost, the middle of the outermost
+    ring sits half a ring inside the largest circle that fits in the image.
+
+*/
+
+enum class Sampling : uint8_t {
+  Nearest,
+  Bilinear,
+};
+
+// One output pixel: src is the top-left of a 2x2 source neighbourhood, fx/fy are the
+// weights (out of 256) of the +x/+y neighbours. Nearest taps have fx = fy = 0
+struct PolarTap {
+  uint32_t src;
+  uint16_t fx;
+  uint16_t fy;
+};
+
+const uint32_t NoSource = 0xffffffff; // outside the source, written as black
+
+// XY image -> polar buffer (laid out with indexAt)
+class PolarMap {
+  public:
+    // storage must hold rings * cols taps
+    PolarMap(PolarTap* storage, uint32_t rings, uint32_t cols);
+
+    // Source images are width x height Pixels, row-major (index y * width + x)
+    void build(uint32_t width, uint32_t height, Sampling sampling = Sampling::Bilinear);
+    void blit(const Pixel* image, Pixel* polar) const;
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    const PolarTap& tap(uint32_t col, uint32_t ring) const { return taps[indexAt(numRings, col, ring)]; }
+
+  private:
+    PolarTap* taps;
+    uint32_t numRings;
+    uint32_t numCols;
+    uint32_t width;
+    Sampling sampling;
+};
+
+// Polar buffer -> XY image, e.g. for previews on the host
+// Taps point at the polar buffer: fx blends towards the next ring, fy towards the next
+// column (wrapping around the sweep). Pixels outside the disc are NoSource.
+class CartesianMap {
+  public:
+    // storage must hold width * height taps
+    CartesianMap(PolarTap* storage, uint32_t width, uint32_t height);
+
+    void build(uint32_t rings, uint32_t cols, Sampling sampling = Sampling::Bilinear);
+    void blit(const Pixel* polar, Pixel* image) const;
+
+    uint32_t width() const { return imgWidth; }
+    uint32_t height() const { return imgHeight; }
+    const PolarTap& tap(uint32_t x, uint32_t y) const { return taps[y * imgWidth + x]; }
+
+  private:
+    PolarTap* taps;
+    uint32_t imgWidth;
+    uint32_t imgHeight;
+    uint32_t numRings;
+    uint32_t numCols;
+    Sampling sampling;
+};
+
+template <uint32_t Rings, uint32_t Cols>
+class StaticPolarMap : public PolarMap {
+  public:
+    StaticPolarMap() : PolarMap(storage, Rings, Cols) {}
+  private:
+    PolarTap storage[Rings * Cols];
+};
+
+template <uint32_t Width, uint32_t Height>
+class StaticCartesianMap : public CartesianMap {
+  public:
+    StaticCartesianMap() : CartesianMap(storage, Width, Height) {}
+  private:
+    PolarTap storage[Width * Height];
+};
+
+#endif // ifndef __POLAR_MAP_H
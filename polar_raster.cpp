@@ -0,0 +1,161 @@
+#include "polar_raster.h"
+
+static const uint32_t FullCoverage = 0x10000;
+
+static inline uint32_t fracOf(int32_t v) {
+  return (uint32_t)v & 0xffff;
+}
+
+// Both out of 0x10000
+static inline uint32_t mulCoverage(uint32_t a, uint32_t b) {
+  return (uint32_t)(((uint64_t)a * b) >> 16);
+}
+
+// color over dst by coverage (out of 0x10000)
+static inline void blendPixel(Pixel& dst, const Pixel& color, uint32_t coverage) {
+  dst = { lerp16(color.blue, dst.blue, coverage),
+          lerp16(color.green, dst.green, coverage),
+          lerp16(color.red, dst.red, coverage) };
+}
+
+static inline int32_t floorDiv(int32_t a, int32_t b) {
+  int32_t q = a / b;
+  return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+PolarRaster::PolarRaster(Pixel* pix, uint32_t rings, uint32_t cols) {
+  pixels = pix;
+  numRings = rings;
+  numCols = cols;
+  antialias = false;
+}
+
+// One column, clipped to the rings. coverage scales the whole span (a partly covered column)
+void PolarRaster::fillSpan(uint32_t col, int32_t ring0, int32_t ring1, Pixel color, uint32_t coverage) {
+  int32_t limit = (int32_t)(numRings << 16);
+  ring0 = ring0 < 0 ? 0 : ring0;
+  ring1 = ring1 > limit ? limit : ring1;
+  if (ring1 <= ring0 || coverage == 0)
+    return;
+  Pixel* column = pixels + indexAt(numRings, col, 0);
+  if (!antialias) { // pixels whose center is inside
+    uint32_t first = (uint32_t)(ring0 + 0x7fff) >> 16;
+    uint32_t last = (uint32_t)(ring1 + 0x7fff) >> 16;
+    vecFill(color, column + first, last - first);
+    return;
+  }
+  uint32_t first = (uint32_t)ring0 >> 16;
+  uint32_t last = (uint32_t)ring1 >> 16; // partly covered ring after the full ones
+  if (first == last) { // inside a single ring
+    blendPixel(column[first], color, mulCoverage(coverage, ring1 - ring0));
+    return;
+  }
+  if (fracOf(ring0)) {
+    blendPixel(column[first], color, mulCoverage(coverage, FullCoverage - fracOf(ring0)));
+    first++;
+  }
+  if (coverage == FullCoverage) {
+    vecFill(color, column + first, last - first);
+  } else {
+    for (uint32_t i = first; i < last; i++)
+      blendPixel(column[i], color, coverage);
+  }
+  if (fracOf(ring1))
+    blendPixel(column[last], color, mulCoverage(coverage, fracOf(ring1)));
+}
+
+// Every ring of count whole columns, wrapping; columns are back to back so this is
+// at most two fills
+void PolarRaster::fillColumns(uint32_t col, uint32_t count, Pixel color) {
+  uint32_t tail = numCols - col;
+  if (count <= tail) {
+    vecFill(color, pixels + indexAt(numRings, col, 0), count * numRings);
+  } else {
+    vecFill(color, pixels + indexAt(numRings, col, 0), tail * numRings);
+    vecFill(color, pixels, (count - tail) * numRings);
+  }
+}
+
+void PolarRaster::span(uint32_t col, int32_t ring0, int32_t ring1, Pixel color) {
+  fillSpan(col % numCols, ring0, ring1, color, FullCoverage);
+}
+
+void PolarRaster::arc(int32_t ring0, int32_t ring1, int32_t col0, int32_t n, Pixel color) {
+  int32_t sweep = (int32_t)(numCols << 16);
+  if (n <= 0 || ring1 <= ring0)
+    return;
+  if (n >= sweep) {
+    n = sweep;
+    col0 = 0;
+  }
+  col0 %= sweep;
+  col0 += col0 < 0 ? sweep : 0;
+  bool allRings = ring0 <= 0 && ring1 >= (int32_t)(numRings << 16);
+
+  uint32_t col, count;
+  if (!antialias) {
+    col = (uint32_t)(col0 + 0x7fff) >> 16;
+    count = (uint32_t)(((int64_t)col0 + n + 0x7fff) >> 16) - col;
+  } else {
+    int64_t end = (int64_t)col0 + n;
+    col = (uint32_t)col0 >> 16;
+    uint32_t endCol = (uint32_t)(end >> 16);
+    if (col == endCol || (col + 1 == endCol && fracOf((int32_t)end) == 0 && fracOf(col0) != 0)) {
+      fillSpan(col % numCols, ring0, ring1, color, n); // all inside one column
+      return;
+    }
+    if (fracOf(col0)) {
+      fillSpan(col, ring0, ring1, color, FullCoverage - fracOf(col0));
+      col++;
+    }
+    if (fracOf((int32_t)end))
+      fillSpan(endCol % numCols, ring0, ring1, color, fracOf((int32_t)end));
+    count = endCol - col;
+  }
+  col = col >= numCols ? col - numCols : col;
+  if (count > numCols)
+    count = numCols;
+  if (allRings) {
+    fillColumns(col, count, color);
+    return;
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    fillSpan(col, ring0, ring1, color, FullCoverage);
+    col = col + 1 == numCols ? 0 : col + 1;
+  }
+}
+
+void PolarRaster::ring(int32_t ring0, int32_t ring1, Pixel color) {
+  arc(ring0, ring1, 0, (int32_t)(numCols << 16), color);
+}
+
+void PolarRaster::spoke(int32_t col, int32_t width, int32_t ring0, int32_t ring1, Pixel color) {
+  if (!antialias && width < 0x10000)
+    width = 0x10000; // would round away to nothing
+  arc(ring0, ring1, col + 0x8000 - width / 2, width, color);
+}
+
+void PolarRaster::sector(int32_t col0, int32_t n, Pixel color) {
+  arc(0, (int32_t)(numRings << 16), col0, n, color);
+}
+
+void PolarRaster::spiral(int32_t ring0, int32_t pitch, int32_t thickness, int32_t rotation, Pixel color) {
+  if (pitch <= 0 || thickness <= 0)
+    return;
+  int32_t limit = (int32_t)(numRings << 16);
+  int32_t sweep = (int32_t)(numCols << 16);
+  int32_t half = thickness / 2;
+  int32_t outer = thickness - half; // a turn covers [center - half, center + outer)
+  rotation %= sweep;
+  rotation += rotation < 0 ? sweep : 0;
+  for (uint32_t col = 0; col < numCols; col++) {
+    // how far round from the start column, 0 - 1 revolution
+    int32_t rel = (int32_t)(col << 16) - rotation;
+    rel += rel < 0 ? sweep : 0;
+    int32_t center = ring0 + (int32_t)(((int64_t)pitch * rel) / sweep);
+    // innermost turn that still reaches the display, then every turn outwards
+    center -= floorDiv(center + outer - 1, pitch) * pitch;
+    for (; center - half < limit; center += pitch)
+      fillSpan(col, center - half, center + outer, color, FullCoverage);
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef __POLAR_RASTER_H
+#define __POLAR_RASTER_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Shape drawing straight in ring/column space
+// Every shape is broken into spans: the rings of one column are contiguous (indexAt), so
+// a span is a single vecFill, and a run of columns covering every ring is one vecFill too.
+// Only the covered pixels are touched, so the cost follows the shape's area, not the
+// buffer size. All positions are 16.16 fixed point (toFixed16), columns wrap around the
+// sweep and rings are clipped to the display.
+// With anti-aliasing on, the pixels a shape only partly covers are blended with what's
+// already there by the covered fraction, instead of rounding the edges to whole pixels.
+//
+//   PolarRaster raster(pixels, rings, cols);
+//   raster.ring(toFixed16(4), toFixed16(6), Colors::Red);
+//   raster.spiral(0, toFixed16(8), toFixed16(1.5), rotation, Colors::Blue);
+
+class PolarRaster {
+  public:
+    PolarRaster(Pixel* pixels, uint32_t rings, uint32_t cols);
+
+    void setBuffer(Pixel* pix) { pixels = pix; }
+    void setAntialias(bool aa) { antialias = aa; }
+
+    // Rings [ring0, ring1) of one column
+    void span(uint32_t col, int32_t ring0, int32_t ring1, Pixel color);
+    // Rings [ring0, ring1) across columns [col0, col0 + numCols), a ring segment
+    void arc(int32_t ring0, int32_t ring1, int32_t col0, int32_t numCols, Pixel color);
+    // Rings [ring0, ring1) all the way around
+    void ring(int32_t ring0, int32_t ring1, Pixel color);
+    // Line from the center outwards, width columns wide centered on column col
+    void spoke(int32_t col, int32_t width, int32_t ring0, int32_t ring1, Pixel color);
+    // Every ring of columns [col0, col0 + numCols), a pie slice
+    void sector(int32_t col0, int32_t numCols, Pixel color);
+    // Archimedean spiral: moves out pitch rings per revolution, starting at ring0 on column
+    // rotation, thickness rings wide. Every turn that fits on the display is drawn
+    void spiral(int32_t ring0, int32_t pitch, int32_t thickness, int32_t rotation, Pixel color);
+
+  private:
+    void fillSpan(uint32_t col, int32_t ring0, int32_t ring1, Pixel color, uint32_t coverage);
+    void fillColumns(uint32_t col, uint32_t count, Pixel color);
+
+    Pixel* pixels;
+    uint32_t numRings;
+    uint32_t numCols;
+    bool antialias;
+};
+
+#endif // ifndef __POLAR_RASTER_H
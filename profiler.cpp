@@ -0,0 +1,87 @@
+#include "profiler.h"
+#include <Arduino.h> // Serial, micros
+#include <string.h> // strcmp
+
+#ifdef TGRAPHICS_PROFILE
+Profiler profiler;
+#endif
+
+Profiler::Profiler() {
+  numProbes = 0;
+  reset();
+}
+
+uint8_t Profiler::probe(const char* name) {
+  for (uint32_t i = 0; i < numProbes; i++) {
+    if (table[i].name == name || strcmp(table[i].name, name) == 0)
+      return i;
+  }
+  if (numProbes == MaxProbes)
+    return NoProbe;
+  if (numProbes == 0)
+    cycleCounterInit();
+  table[numProbes].name = name;
+  return numProbes++;
+}
+
+void Profiler::reset() {
+  for (uint32_t i = 0; i < MaxProbes; i++) {
+    ProbeStats& s = table[i];
+    s.count = 0;
+    s.minCycles = 0xffffffff;
+    s.maxCycles = 0;
+    s.totalCycles = 0;
+    for (uint32_t b = 0; b < ProbeBuckets; b++)
+      s.buckets[b] = 0;
+  }
+}
+
+float Profiler::cyclesPerUs() const {
+#if defined(__arm__) && defined(F_CPU)
+  return F_CPU / 1000000.0f;
+#elif !defined(__arm__) && (defined(__x86_64__) || defined(__i386__))
+  // TSC rate isn't known up front, time it against micros() once (~10ms)
+  static float rate = 0.0f;
+  if (rate == 0.0f) {
+    uint32_t us0 = micros();
+    uint32_t c0 = cycleCount();
+    while (micros() - us0 < 10000) {
+    }
+    rate = (float)(cycleCount() - c0) / (micros() - us0);
+  }
+  return rate;
+#else
+  return 1000.0f; // nanosecond counter
+#endif
+}
+
+void Profiler::dump() const {
+  float rate = cyclesPerUs();
+  Serial.println("probe: count min/mean/max cycles, max us | log2(cycles):count");
+  for (uint32_t i = 0; i < numProbes; i++) {
+    const ProbeStats& s = table[i];
+    if (s.count == 0)
+      continue;
+    Serial.print(s.name);
+    Serial.print(": ");
+    Serial.print((unsigned long)s.count);
+    Serial.print(' ');
+    Serial.print((unsigned long)s.minCycles);
+    Serial.print('/');
+    Serial.print((unsigned long)(s.totalCycles / s.count));
+    Serial.print('/');
+    Serial.print((unsigned long)s.maxCycles);
+    Serial.print(' ');
+    Serial.print(s.maxCycles / rate, 1);
+    Serial.print("us |");
+    for (uint32_t b = 0; b < ProbeBuckets; b++) {
+      if (!s.buckets[b])
+        continue;
+      Serial.print(' ');
+      Serial.print((unsigned long)b);
+      Serial.print(':');
+      Serial.print((unsigned long)s.buckets[b]);
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,121 @@
+#ifndef __PROFILER_H
+#define __PROFILER_H
+#include <cstdint>
+#if !defined(__arm__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h> // __rdtsc
+#elif !defined(__arm__)
+#include <time.h> // clock_gettime
+#endif
+
+// Cycle-level profiling probes
+// TGRAPHICS_PROBE("name") at the top of a block times the rest of the block. Every probe
+// keeps count/min/mean/max and a histogram (bucket b counts runs of 2^b - 2^(b+1)-1
+// cycles) in a fixed table; profiler.dump() prints them to Serial.
+// Build with TGRAPHICS_PROFILE defined (everywhere, it changes inline functions) to turn
+// the probes on, without it they compile to nothing and there's no profiler.
+//
+//   void MyDemo::tick() {
+//     TGRAPHICS_PROBE("MyDemo::tick");
+//     ...
+//   }
+
+// Cycle counter: DWT CYCCNT on Cortex-M, the TSC on x86 hosts, nanoseconds elsewhere
+#if defined(__arm__)
+#define TGRAPHICS_DEMCR (*(volatile uint32_t*)0xE000EDFC)
+#define TGRAPHICS_DWT_CTRL (*(volatile uint32_t*)0xE0001000)
+#define TGRAPHICS_DWT_CYCCNT (*(volatile uint32_t*)0xE0001004)
+#endif
+
+// Teensy 4 has the counter running already, Teensy 3.x needs it switched on
+inline void cycleCounterInit() {
+#if defined(__arm__)
+  TGRAPHICS_DEMCR |= 1 << 24; // TRCENA
+  TGRAPHICS_DWT_CTRL |= 1;    // CYCCNTENA
+#endif
+}
+
+// Wraps; only differences of two reads mean anything
+inline uint32_t cycleCount() {
+#if defined(__arm__)
+  return TGRAPHICS_DWT_CYCCNT;
+#elif defined(__x86_64__) || defined(__i386__)
+  return (uint32_t)__rdtsc();
+#else
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+#endif
+}
+
+const uint32_t MaxProbes = 32;
+const uint32_t ProbeBuckets = 32;
+const uint8_t NoProbe = 0xff; // table full, records are dropped
+
+struct ProbeStats {
+  const char* name;
+  uint32_t count;
+  uint32_t minCycles;
+  uint32_t maxCycles;
+  uint64_t totalCycles;
+  uint32_t buckets[ProbeBuckets];
+};
+
+class Profiler {
+  public:
+    Profiler();
+
+    // Id for name, registering it on first use
+    uint8_t probe(const char* name);
+
+    void record(uint8_t id, uint32_t cycles) {
+      if (id == NoProbe)
+        return;
+      ProbeStats& s = table[id];
+      s.count++;
+      s.totalCycles += cycles;
+      s.minCycles = cycles < s.minCycles ? cycles : s.minCycles;
+      s.maxCycles = cycles > s.maxCycles ? cycles : s.maxCycles;
+      s.buckets[cycles ? 31 - __builtin_clz(cycles) : 0]++;
+    }
+
+    uint32_t probes() const { return numProbes; }
+    const ProbeStats& stats(uint32_t id) const { return table[id]; }
+    // Clears the numbers, probes stay registered
+    void reset();
+
+    float cyclesPerUs() const;
+    // One line per probe: count, min/mean/max in cycles, max in us, then the
+    // non-empty histogram buckets as log2:count
+    void dump() const;
+
+  private:
+    ProbeStats table[MaxProbes];
+    uint32_t numProbes;
+};
+
+// Only there in profiling builds, so the table costs no RAM otherwise
+#ifdef TGRAPHICS_PROFILE
+extern Profiler profiler;
+
+class ScopedProbe {
+  public:
+    ScopedProbe(uint8_t probeId) : id(probeId), start(cycleCount()) {}
+    ~ScopedProbe() { profiler.record(id, cycleCount() - start); }
+  private:
+    uint8_t id;
+    uint32_t start;
+};
+#endif
+
+#define TGRAPHICS_PROBE_CAT2(a, b) a##b
+#define TGRAPHICS_PROBE_CAT(a, b) TGRAPHICS_PROBE_CAT2(a, b)
+
+#ifdef TGRAPHICS_PROFILE
+#define TGRAPHICS_PROBE(name) \
+  static const uint8_t TGRAPHICS_PROBE_CAT(tgProbeId, __LINE__) = profiler.probe(name); \
+  ScopedProbe TGRAPHICS_PROBE_CAT(tgProbe, __LINE__)(TGRAPHICS_PROBE_CAT(tgProbeId, __LINE__))
+#else
+#define TGRAPHICS_PROBE(name) do {} while (0)
+#endif
+
+#endif // ifndef __PROFILER_H
@@ -0,0 +1,113 @@
+#ifndef __ROTATION_VIEW_H
+#define __ROTATION_VIEW_H
+#include "tgraphics.h"
+#include <cstdint>
+
+// Rotated view of a circular Pixel buffer (laid out with indexAt)
+// Rotating the whole image only changes the view's column offset, nothing is copied:
+// view column c shows buffer column c + rotation. The rotation is 16.16 fixed point
+// columns, reads between two columns blend them (get(), OutputStage::writeColumn),
+// writes and the vec* range kernels use the whole column part.
+
+class RotatedView {
+  public:
+    RotatedView(Pixel* pixels, uint32_t rings, uint32_t cols) {
+      buffer = pixels;
+      numRings = rings;
+      numCols = cols;
+      setRotation(0);
+    }
+
+    // offset in 16.16 columns, wrapped onto one revolution
+    void setRotation(uint32_t offsetQ16) {
+      offset = offsetQ16 % (numCols << 16);
+    }
+    void rotate(int32_t deltaQ16) {
+      int64_t o = ((int64_t)offset + deltaQ16) % ((int64_t)numCols << 16);
+      offset = (uint32_t)(o < 0 ? o + ((int64_t)numCols << 16) : o);
+    }
+    uint32_t rotation() const { return offset; }
+    uint16_t fraction() const { return offset & 0xffff; } // Q0.16 towards the next column
+
+    uint32_t rings() const { return numRings; }
+    uint32_t cols() const { return numCols; }
+    Pixel* pixels() const { return buffer; }
+
+    // col must be < cols()
+    uint32_t physicalColumn(uint32_t col) const {
+      uint32_t c = col + (offset >> 16);
+      return c >= numCols ? c - numCols : c;
+    }
+
+    uint32_t index(uint32_t col, uint32_t ring) const {
+      return indexAt(numRings, physicalColumn(col), ring);
+    }
+
+    Pixel* column(uint32_t col) const {
+      return buffer + index(col, 0);
+    }
+
+    // Column after col (in view order), for blending fractional rotations
+    Pixel* nextColumn(uint32_t col) const {
+      return column(col + 1 == numCols ? 0 : col + 1);
+    }
+
+    Pixel get(uint32_t col, uint32_t ring) const {
+      Pixel p = column(col)[ring];
+      uint32_t w = fraction();
+      if (w == 0)
+        return p;
+      Pixel n = nextColumn(col)[ring];
+      return { lerp16(n.blue, p.blue, w), lerp16(n.green, p.green, w), lerp16(n.red, p.red, w) };
+    }
+
+    void set(uint32_t col, uint32_t ring, const Pixel& p) {
+      column(col)[ring] = p;
+    }
+
+    // fn(Pixel* start, uint32_t numPixels) over the (at most 2) contiguous runs of the
+    // buffer that hold view columns [firstCol, firstCol + count)
+    template <typename F>
+    void forEachRun(uint32_t firstCol, uint32_t count, F fn) const {
+      if (count > numCols)
+        count = numCols;
+      uint32_t start = physicalColumn(firstCol % numCols);
+      uint32_t tail = numCols - start;
+      if (count <= tail) {
+        fn(buffer + indexAt(numRings, start, 0), count * numRings);
+      } else {
+        fn(buffer + indexAt(numRings, start, 0), tail * numRings);
+        fn(buffer, (count - tail) * numRings);
+      }
+    }
+
+  private:
+    Pixel* buffer;
+    uint32_t numRings;
+    uint32_t numCols;
+    uint32_t offset;
+};
+
+//-------------------------//
+
+// vec* kernels over a range of view columns
+
+//-------------------------//
+
+inline void vecFill(const Pixel src, const RotatedView& view, uint32_t firstCol, uint32_t numCols) {
+  view.forEachRun(firstCol, numCols, [&](Pixel* run, uint32_t n) { vecFill(src, run, n); });
+}
+
+inline void vecFade(const RotatedView& view, uint32_t firstCol, uint32_t numCols, uint16_t fadeAmt) {
+  view.forEachRun(firstCol, numCols, [&](Pixel* run, uint32_t n) { vecFade(run, run, fadeAmt, n); });
+}
+
+inline void vecBrighten(const RotatedView& view, uint32_t firstCol, uint32_t numCols, uint16_t amt) {
+  view.forEachRun(firstCol, numCols, [&](Pixel* run, uint32_t n) { vecBrighten(run, run, amt, n); });
+}
+
+inline void vecScale(const RotatedView& view, uint32_t firstCol, uint32_t numCols, Scale16 scale) {
+  view.forEachRun(firstCol, numCols, [&](Pixel* run, uint32_t n) { vecScale(run, run, scale, n); });
+}
+
+#endif // ifndef __ROTATION_VIEW_H
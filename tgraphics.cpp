@@ -63,3 +63,250 @@ void SimpleTimer::update(uint32_t target) {
   microDuration = target;
   microStart = micros(); // Note: resets counter
 }
+
+
+//#######################
+// Separable convolution
+//#######################
+
+// Q15 accumulator back to a T channel, rounding and saturating
+template <typename T, typename Acc>
+static inline T q15Result(Acc acc) {
+  acc = (acc + 0x4000) >> 15;
+  return acc < 0 ? 0 : acc > channelMax<T>() ? channelMax<T>() : acc;
+}
+
+// out[i] = sum(taps[k] * rows[k][i]), N fixed so the 3/5 tap loops unroll
+template <uint32_t N, typename T>
+static void accumulateLines(const T* const* rows, const int16_t* taps, T* out, uint32_t count) {
+  // locals, otherwise every store to out forces a reload of the rows/taps
+  const T* r[N];
+  int32_t t[N];
+  for (uint32_t k = 0; k < N; k++) {
+    r[k] = rows[k];
+    t[k] = taps[k];
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    int32_t acc = 0;
+    for (uint32_t k = 0; k < N; k++)
+      acc += t[k] * r[k][i];
+    out[i] = q15Result<T>(acc);
+  }
+}
+
+template <typename Acc, typename T>
+static void accumulateLines(const T* const* rows, const int16_t* taps, uint32_t numTaps,
+                            T* out, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    Acc acc = 0;
+    for (uint32_t k = 0; k < numTaps; k++)
+      acc += (Acc)taps[k] * rows[k][i];
+    out[i] = q15Result<T>(acc);
+  }
+}
+
+// out[i] = sum(taps[k] * in[i + k * Step]), in already has the halo in front
+// N and Step (channels per pixel) fixed so the loop unrolls and vectorizes
+template <uint32_t N, uint32_t Step, typename T>
+static void convolveRun(const T* in, const int16_t* taps, T* out, uint32_t count) {
+  int32_t t[N];
+  for (uint32_t k = 0; k < N; k++)
+    t[k] = taps[k];
+  for (uint32_t i = 0; i < count; i++) {
+    int32_t acc = 0;
+    for (uint32_t k = 0; k < N; k++)
+      acc += t[k] * in[i + k * Step];
+    out[i] = q15Result<T>(acc);
+  }
+}
+
+template <uint32_t N, typename T>
+static bool convolveRunFast(const T* in, const int16_t* taps, uint32_t step, T* out, uint32_t count) {
+  switch (step) {
+    case 1:
+      convolveRun<N, 1, T>(in, taps, out, count);
+      return true;
+    case 3:
+      convolveRun<N, 3, T>(in, taps, out, count);
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <typename Acc, typename T>
+static void convolveRun(const T* in, const int16_t* taps, uint32_t numTaps, uint32_t step,
+                        T* out, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    Acc acc = 0;
+    for (uint32_t k = 0; k < numTaps; k++)
+      acc += (Acc)taps[k] * in[i + k * step];
+    out[i] = q15Result<T>(acc);
+  }
+}
+
+// True when the taps can push an int32 accumulator past its range on T data
+// (positive or negative taps summing well over 1.0), those kernels take the int64 loops
+template <typename T>
+static bool needsWideAccumulator(const Kernel15& kernel) {
+  int64_t pos = 0, neg = 0;
+  for (uint32_t k = 0; k < kernel.size; k++) {
+    if (kernel.taps[k] > 0)
+      pos += kernel.taps[k];
+    else
+      neg -= kernel.taps[k];
+  }
+  const int64_t limit = INT32_MAX - 0x4000;
+  return pos * channelMax<T>() > limit || neg * channelMax<T>() > limit;
+}
+
+// Copies elements [vStart, vStart + n) of the virtual line (left halo, line, right halo) into buf
+template <typename T>
+static void loadHaloLine(T* buf, uint32_t vStart, uint32_t n,
+                         const T* left, const T* line, const T* right,
+                         uint32_t haloElems, uint32_t lineElems) {
+  uint32_t vEnd = vStart + n;
+  uint32_t midStart = haloElems, midEnd = haloElems + lineElems;
+  for (uint32_t j = vStart; j < vEnd && j < midStart; j++)
+    *buf++ = left[j];
+  if (vEnd > midStart && vStart < midEnd) {
+    uint32_t from = vStart > midStart ? vStart : midStart;
+    uint32_t to = vEnd < midEnd ? vEnd : midEnd;
+    memcpy(buf, line + (from - midStart), (to - from) * sizeof(T));
+    buf += to - from;
+  }
+  for (uint32_t j = vStart > midEnd ? vStart : midEnd; j < vEnd; j++)
+    *buf++ = right[j - midEnd];
+}
+
+// Pass 1: every output line is a weighted sum of whole source lines.
+// Edges are resolved once per line into a list of source rows (black rows are skipped).
+template <typename T>
+static void convolveAcrossLines(const T* src, T* dst, const ImageLayout& layout,
+                                const Kernel15& kernel, EdgeType edge) {
+  const bool wide = needsWideAccumulator<T>(kernel);
+  const uint32_t lineElems = layout.lineLen * layout.channels;
+  const int32_t halo = kernel.size / 2;
+  const T* rows[MaxKernelTaps];
+  int16_t taps[MaxKernelTaps];
+
+  for (uint32_t y = 0; y < layout.numLines; y++) {
+    uint32_t numTaps = 0;
+    for (uint32_t k = 0; k < kernel.size; k++) {
+      int32_t srcLine = edgeIndex(edge, (int32_t)y + (int32_t)k - halo, layout.numLines);
+      if (srcLine < 0 || kernel.taps[k] == 0)
+        continue;
+      rows[numTaps] = src + srcLine * layout.lineStride;
+      taps[numTaps] = kernel.taps[k];
+      numTaps++;
+    }
+
+    T* out = dst + y * layout.lineStride;
+    if (wide) {
+      accumulateLines<int64_t>(rows, taps, numTaps, out, lineElems);
+      continue;
+    }
+    switch (numTaps) {
+      case 0:
+        memset(out, 0, lineElems * sizeof(T));
+        break;
+      case 1:
+        accumulateLines<1, T>(rows, taps, out, lineElems);
+        break;
+      case 3:
+        accumulateLines<3, T>(rows, taps, out, lineElems);
+        break;
+      case 5:
+        accumulateLines<5, T>(rows, taps, out, lineElems);
+        break;
+      default:
+        accumulateLines<int32_t>(rows, taps, numTaps, out, lineElems);
+        break;
+    }
+  }
+}
+
+// Pass 2: convolve each line in place, streaming it through a fixed size buffer
+// that carries the halo, so no full-frame scratch buffer is needed.
+template <typename T>
+static void convolveAlongLines(T* img, const ImageLayout& layout, const Kernel15& kernel, EdgeType edge) {
+  const uint32_t chunkElems = 256;
+  const uint32_t ch = layout.channels;
+  const uint32_t lineElems = layout.lineLen * ch;
+  const uint32_t halo = kernel.size / 2;
+  const uint32_t haloElems = halo * ch;
+  const bool wide = needsWideAccumulator<T>(kernel);
+
+  T left[MaxKernelHalo * MaxImageChannels];
+  T right[MaxKernelHalo * MaxImageChannels];
+  T buf[chunkElems + 2 * MaxKernelHalo * MaxImageChannels];
+
+  for (uint32_t y = 0; y < layout.numLines; y++) {
+    T* line = img + y * layout.lineStride;
+
+    // Halos come from the untouched line, so wrap still sees the original far end
+    for (uint32_t i = 1; i <= halo; i++) {
+      int32_t l = edgeIndex(edge, -(int32_t)i, layout.lineLen);
+      int32_t r = edgeIndex(edge, layout.lineLen - 1 + i, layout.lineLen);
+      for (uint32_t c = 0; c < ch; c++) {
+        left[(halo - i) * ch + c] = l < 0 ? 0 : line[l * ch + c];
+        right[(i - 1) * ch + c] = r < 0 ? 0 : line[r * ch + c];
+      }
+    }
+
+    // buf[p] holds virtual element x0 + p, the line is overwritten behind the read position
+    uint32_t count = lineElems < chunkElems ? lineElems : chunkElems;
+    loadHaloLine(buf, 0, count + 2 * haloElems, left, line, right, haloElems, lineElems);
+    for (uint32_t x0 = 0; x0 < lineElems;) {
+      bool done = false;
+      switch (wide ? 0 : kernel.size) {
+        case 1:
+          done = convolveRunFast<1>(buf, kernel.taps, ch, line + x0, count);
+          break;
+        case 3:
+          done = convolveRunFast<3>(buf, kernel.taps, ch, line + x0, count);
+          break;
+        case 5:
+          done = convolveRunFast<5>(buf, kernel.taps, ch, line + x0, count);
+          break;
+      }
+      if (wide)
+        convolveRun<int64_t>(buf, kernel.taps, kernel.size, ch, line + x0, count);
+      else if (!done)
+        convolveRun<int32_t>(buf, kernel.taps, kernel.size, ch, line + x0, count);
+      x0 += count;
+      if (x0 >= lineElems)
+        break;
+      memmove(buf, buf + count, 2 * haloElems * sizeof(T));
+      count = lineElems - x0 < chunkElems ? lineElems - x0 : chunkElems;
+      loadHaloLine(buf + 2 * haloElems, x0 + 2 * haloElems, count, left, line, right, haloElems, lineElems);
+    }
+  }
+}
+
+template <typename T>
+void convolveSeparable(const T* src,
+                       T* dst,
+                       const ImageLayout& layout,
+                       const Kernel15& kernelAlong,
+                       const Kernel15& kernelAcross,
+                       EdgePolicy edges) {
+  TGRAPHICS_PROBE("convolveSeparable");
+  bool valid = layout.channels > 0 && layout.channels <= MaxImageChannels &&
+               kernelAlong.size % 2 == 1 && kernelAlong.size <= MaxKernelTaps &&
+               kernelAcross.size % 2 == 1 && kernelAcross.size <= MaxKernelTaps;
+  if (!valid) { // pass the image through unchanged rather than leave dst stale
+    for (uint32_t y = 0; y < layout.numLines; y++)
+      memcpy(dst + y * layout.lineStride, src + y * layout.lineStride, layout.lineLen * layout.channels * sizeof(T));
+    return;
+  }
+
+  convolveAcrossLines(src, dst, layout, kernelAcross, edges.across);
+  convolveAlongLines(dst, layout, kernelAlong, edges.along);
+}
+
+// Pixel8 and Pixel planes, nothing else is built
+template void convolveSeparable<uint8_t>(const uint8_t*, uint8_t*, const ImageLayout&, const Kernel15&,
+                                         const Kernel15&, EdgePolicy);
+template void convolveSeparable<uint16_t>(const uint16_t*, uint16_t*, const ImageLayout&, const Kernel15&,
+                                          const Kernel15&, EdgePolicy);
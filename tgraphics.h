@@ -3,6 +3,19 @@
 #include <Arduino.h> // micros
 #include <arm_math.h>
 #include <cstdint>
+#include <cstring> // memcpy
+#include "profiler.h" // TGRAPHICS_PROBE
+
+// SIMD backend for the saturating vec* kernels, scalar loops are used otherwise
+#if defined(__arm__) && defined(__ARM_FEATURE_DSP) // Cortex-M4/M7 (Teensy 3.x/4.x)
+#define TGRAPHICS_SIMD_DSP
+#elif defined(__SSE2__) // host build
+#include <emmintrin.h>
+#define TGRAPHICS_SIMD_SSE2
+#elif defined(__ARM_NEON) // host build on ARM
+#include <arm_neon.h>
+#define TGRAPHICS_SIMD_NEON
+#endif
 
 // Animation ideas
 // Moving dots (flying around bouncing, added with each keypress)
@@ -99,6 +112,210 @@ inline uint16_t qmult16(uint16_t a, float b) {
 
 // division is already saturating for uints
 
+// Fixed-point scale factor in unsigned Q8.8: 0x0100 is 1.0, 0xffff is ~256.0
+// Use this instead of a float multiplier in per-pixel loops
+struct Scale16 {
+    uint16_t q;
+};
+
+const Scale16 ScaleOne = { 0x0100 };
+
+inline Scale16 toScale16(float f) {
+    if (f <= 0.0f)
+        return { 0 };
+    if (f >= 255.99f)
+        return { 0xffff };
+    return { (uint16_t)(f * 256.0f + 0.5f) };
+}
+
+// Signed 16.16, used for positions in ring/column space
+inline int32_t toFixed16(float v) {
+    return (int32_t)(v * 65536.0f);
+}
+
+inline uint16_t qmult16(uint16_t a, Scale16 b) {
+    uint32_t c = ((uint32_t)a * b.q) >> 8;
+    if (c > 0xFFFF)
+        c = 0xFFFF;
+    return c;
+}
+
+// Maps a Q0.16 fraction (0-0xffff) to a weight out of 0x10000, so 0xffff is exactly 1.0
+constexpr uint32_t fracWeight16(uint16_t frac) {
+    return (uint32_t)frac + (frac >> 15);
+}
+
+// a * frac + b * (1 - frac), frac in Q0.16. Can't overflow, weights sum to 0x10000
+constexpr uint16_t lerp16(uint16_t a, uint16_t b, uint32_t weight) {
+    return ((uint32_t)a * weight + (uint32_t)b * (0x10000 - weight)) >> 16;
+}
+
+// 8-bit channel versions, for Pixel8
+inline uint8_t qadd8(uint8_t a, uint8_t b) {
+    uint8_t c = a + b;
+    if (c < a)
+        c = 0xFF;
+    return c;
+}
+
+inline uint8_t qsub8(uint8_t a, uint8_t b) {
+    uint8_t c = a - b;
+    if (c > a)
+        c = 0;
+    return c;
+}
+
+// Same saturating math for either channel depth, what PixelT is built on
+template <typename T>
+constexpr T channelMax() {
+    return (T)~(T)0;
+}
+
+template <typename T>
+inline T qadd(T a, T b) {
+    T c = a + b;
+    if (c < a)
+        c = channelMax<T>();
+    return c;
+}
+
+template <typename T>
+inline T qsub(T a, T b) {
+    T c = a - b;
+    if (c > a)
+        c = 0;
+    return c;
+}
+
+template <typename T>
+inline T qmult(T a, T b) {
+    T c = a * b;
+    if (c < a)
+        c = channelMax<T>();
+    return c;
+}
+
+template <typename T>
+inline T qmult(T a, float b) {
+    T c = a * b;
+    if (b < 0.0)
+        c = 0x0;
+    if (c < a && b > 1.0)
+        c = channelMax<T>();
+    return c;
+}
+
+template <typename T>
+inline T qmult(T a, Scale16 b) {
+    uint32_t c = ((uint32_t)a * b.q) >> 8;
+    if (c > channelMax<T>())
+        c = channelMax<T>();
+    return c;
+}
+
+// 8 -> 16 bit channel, 0xff becomes 0xffff. Only the output stage should need it
+constexpr uint16_t widen16(uint8_t v) {
+    return (uint16_t)((v << 8) | v);
+}
+
+constexpr uint16_t widen16(uint16_t v) {
+    return v;
+}
+
+// Keeps a parameter out of template argument deduction, so Colors:: and plain ints
+// still convert when passed next to a PixelT
+template <typename T>
+struct NoDeduce {
+    typedef T type;
+};
+
+// Order the 3 channels of an LED are wired to the driver, first GS entry first.
+// Also the order a PixelT keeps its channels in memory, first member first
+enum class ChannelOrder : uint8_t {
+  RGB,
+  RBG,
+  BGR, // what the TLCs are set up to do
+  BRG,
+  GBR,
+  GRB,
+};
+
+struct ChannelOffsets {
+  uint8_t blue;
+  uint8_t green;
+  uint8_t red;
+
+  constexpr bool operator==(const ChannelOffsets& other) const {
+    return blue == other.blue && green == other.green && red == other.red;
+  }
+};
+
+constexpr ChannelOffsets channelOffsets(ChannelOrder order) {
+  return order == ChannelOrder::RGB ? ChannelOffsets{ 2, 1, 0 } :
+         order == ChannelOrder::RBG ? ChannelOffsets{ 1, 2, 0 } :
+         order == ChannelOrder::BGR ? ChannelOffsets{ 0, 1, 2 } :
+         order == ChannelOrder::BRG ? ChannelOffsets{ 0, 2, 1 } :
+         order == ChannelOrder::GBR ? ChannelOffsets{ 1, 0, 2 } :
+                                      ChannelOffsets{ 2, 0, 1 }; // GRB
+}
+
+// Order Pixel and Pixel8 are stored in. Define it (e.g. -DTGRAPHICS_CHANNEL_ORDER=GRB)
+// to the board's wiring and OutputStage copies the channels straight through
+#ifndef TGRAPHICS_CHANNEL_ORDER
+#define TGRAPHICS_CHANNEL_ORDER BGR
+#endif
+constexpr ChannelOrder NativeOrder = ChannelOrder::TGRAPHICS_CHANNEL_ORDER;
+
+// Member layout of a PixelT, one per ChannelOrder. The constructor always takes
+// blue, green, red, so PixelT{ b, g, r } means the same thing whatever the order
+template <typename T, ChannelOrder Order>
+struct PixelChannels;
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::RGB> {
+    T red, green, blue;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : red(r), green(g), blue(b) {}
+};
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::RBG> {
+    T red, blue, green;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : red(r), blue(b), green(g) {}
+};
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::BGR> {
+    T blue, green, red;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : blue(b), green(g), red(r) {}
+};
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::BRG> {
+    T blue, red, green;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : blue(b), red(r), green(g) {}
+};
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::GBR> {
+    T green, blue, red;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : green(g), blue(b), red(r) {}
+};
+
+template <typename T>
+struct PixelChannels<T, ChannelOrder::GRB> {
+    T green, red, blue;
+    PixelChannels() = default;
+    constexpr PixelChannels(T b, T g, T r) : green(g), red(r), blue(b) {}
+};
+
+template <typename T, ChannelOrder Order = NativeOrder>
+struct PixelT;
+
 struct rgb_struct;
 struct rbg_struct;
 struct bgr_struct;
@@ -106,99 +323,130 @@ struct brg_struct;
 struct gbr_struct;
 struct grb_struct;
 
-struct Pixel {
-    uint16_t blue;
-    uint16_t green;
-    uint16_t red;
-
-    friend Pixel operator+(Pixel lhs, const Pixel& rhs) {
-        lhs.blue = qadd16(lhs.blue,rhs.blue);
-        lhs.green = qadd16(lhs.green,rhs.green);
-        lhs.red = qadd16(lhs.red,rhs.red);
+// Pixel with T channels, stored in Order. Pixel (uint16_t) is the default and what the
+// FrameBuffer, compositor, demos etc. work in. Pixel8 (uint8_t) is half the RAM, enough
+// for the 8-bit Colors:: and anything built from them, and the saturating kernels do
+// twice the channels per instruction. Channels only get widened to 16 bits by OutputStage.
+template <typename T, ChannelOrder Order>
+struct PixelT : PixelChannels<T, Order> {
+    typedef T Storage;
+    static constexpr ChannelOrder order = Order;
+
+    PixelT() = default;
+    constexpr PixelT(T b, T g, T r) : PixelChannels<T, Order>(b, g, r) {}
+
+    friend PixelT operator+(PixelT lhs, const PixelT& rhs) {
+        lhs.blue = qadd(lhs.blue,rhs.blue);
+        lhs.green = qadd(lhs.green,rhs.green);
+        lhs.red = qadd(lhs.red,rhs.red);
         return lhs;
     }
 
-    friend Pixel operator+(Pixel lhs, uint16_t rhs) {
-        lhs.blue = qadd16(lhs.blue,rhs);
-        lhs.green = qadd16(lhs.green,rhs);
-        lhs.red = qadd16(lhs.red,rhs);
+    friend PixelT operator+(PixelT lhs, T rhs) {
+        lhs.blue = qadd(lhs.blue,rhs);
+        lhs.green = qadd(lhs.green,rhs);
+        lhs.red = qadd(lhs.red,rhs);
         return lhs;
     }
 
-    friend Pixel operator-(Pixel lhs, const Pixel& rhs) {
-        lhs.blue = qsub16(lhs.blue,rhs.blue);
-        lhs.green = qsub16(lhs.green,rhs.green);
-        lhs.red = qsub16(lhs.red,rhs.red);
+    friend PixelT operator-(PixelT lhs, const PixelT& rhs) {
+        lhs.blue = qsub(lhs.blue,rhs.blue);
+        lhs.green = qsub(lhs.green,rhs.green);
+        lhs.red = qsub(lhs.red,rhs.red);
         return lhs;
     }
 
-    friend Pixel operator-(Pixel lhs, uint16_t rhs) {
-        lhs.blue = qsub16(lhs.blue,rhs);
-        lhs.green = qsub16(lhs.green,rhs);
-        lhs.red = qsub16(lhs.red,rhs);
+    friend PixelT operator-(PixelT lhs, T rhs) {
+        lhs.blue = qsub(lhs.blue,rhs);
+        lhs.green = qsub(lhs.green,rhs);
+        lhs.red = qsub(lhs.red,rhs);
         return lhs;
     }
 
 
-    friend Pixel operator*(Pixel lhs, const Pixel& rhs) {
-        lhs.blue = qmult16(lhs.blue,rhs.blue);
-        lhs.green = qmult16(lhs.green,rhs.green);
-        lhs.red = qmult16(lhs.red,rhs.red);
+    friend PixelT operator*(PixelT lhs, const PixelT& rhs) {
+        lhs.blue = qmult(lhs.blue,rhs.blue);
+        lhs.green = qmult(lhs.green,rhs.green);
+        lhs.red = qmult(lhs.red,rhs.red);
+        return lhs;
+    }
+
+    friend PixelT operator*(PixelT lhs, float rhs) {
+        lhs.blue = qmult(lhs.blue,rhs);
+        lhs.green = qmult(lhs.green,rhs);
+        lhs.red = qmult(lhs.red,rhs);
         return lhs;
     }
 
-    friend Pixel operator*(Pixel lhs, float rhs) {
-        lhs.blue = qmult16(lhs.blue,rhs);
-        lhs.green = qmult16(lhs.green,rhs);
-        lhs.red = qmult16(lhs.red,rhs);
+    friend PixelT operator*(PixelT lhs, Scale16 rhs) {
+        lhs.blue = qmult(lhs.blue,rhs);
+        lhs.green = qmult(lhs.green,rhs);
+        lhs.red = qmult(lhs.red,rhs);
         return lhs;
     }
-    bool operator==(const Pixel &other) {
-        return red == other.red && blue == other.blue && green == other.green;
+    bool operator==(const PixelT &other) const {
+        return this->red == other.red && this->blue == other.blue && this->green == other.green;
     }
 };
 
+using Pixel = PixelT<uint16_t>;
+using Pixel8 = PixelT<uint8_t>;
 
-inline Pixel lerp_float(const Pixel& a, const Pixel& b, float frac) {
-    if (frac > 1.0) frac = 1.0;
-    else if (frac < 0.0) frac = 0.0;
-    return a * frac + b * (1. - frac);
+
+// frac is Q0.16: 0 gives b, 0xffff gives a
+template <typename T, ChannelOrder O>
+inline PixelT<T, O> lerp_uint(const PixelT<T, O>& a, const PixelT<T, O>& b, uint16_t frac) {
+    uint32_t weight = fracWeight16(frac);
+    return { (T)lerp16(a.blue, b.blue, weight),
+             (T)lerp16(a.green, b.green, weight),
+             (T)lerp16(a.red, b.red, weight) };
 }
 
-inline Pixel lerp_uint(const Pixel& a, const Pixel& b, uint16_t frac) {
-    return lerp_float(a,b,((float)frac / 65535.));
+template <typename T, ChannelOrder O>
+inline PixelT<T, O> lerp_float(const PixelT<T, O>& a, const PixelT<T, O>& b, float frac) {
+    if (frac > 1.0) frac = 1.0;
+    else if (frac < 0.0) frac = 0.0;
+    return lerp_uint(a, b, (uint16_t)(frac * 65535.0f + 0.5f));
 }
 
 
+// The color structs convert to any PixelT at compile time, straight into its storage order.
+// Colors:: are all 8-bit, so nothing is lost in a Pixel8
 
 struct rgb_struct {
   uint16_t r, g , b;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 };
 
 struct rbg_struct {
   uint16_t r, b, g;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 };
 
 struct bgr_struct {
   uint16_t b, g, r;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 };
 
 struct brg_struct {
   uint16_t b, r, g;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 };
 
 struct gbr_struct {
   uint16_t g, b, r;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 } ;
 
 struct grb_struct {
   uint16_t g, r, b;
-  operator Pixel() const { return {.blue = b, .green = g, .red = r}; }
+  template <typename T, ChannelOrder O>
+  constexpr operator PixelT<T, O>() const { return { (T)b, (T)g, (T)r }; }
 };
 
 using RGB_Color = rgb_struct;
@@ -244,8 +492,44 @@ enum class EdgeType : uint16_t {
   Reflect = 2,
   Copy = 3,
   Black = 4,
+  Clamp = 5,
+};
+
+// Edge handling per axis. For the POV buffer a line is a column, so `along` is
+// across the rings (the radius) and `across` is across the columns (the sweep)
+struct EdgePolicy {
+  EdgeType along;
+  EdgeType across;
 };
 
+// The sweep is periodic, so columns wrap around while the inner/outer rings don't
+const EdgePolicy Cylindrical = { EdgeType::Clamp, EdgeType::Wrap };
+const EdgePolicy CylindricalBlack = { EdgeType::Black, EdgeType::Wrap };
+
+// Maps an out of range pixel index onto the image, or returns -1 for black
+inline int32_t edgeIndex(EdgeType e, int32_t i, int32_t size) {
+  if (i >= 0 && i < size)
+    return i;
+  switch (e) {
+    case EdgeType::Wrap:
+      i %= size;
+      return i < 0 ? i + size : i;
+    case EdgeType::Reflect: {
+      int32_t period = 2 * size;
+      i %= period;
+      if (i < 0) i += period;
+      return i < size ? i : period - i - 1;
+    }
+    case EdgeType::Copy: // halo copies the nearest edge pixel
+    case EdgeType::Clamp:
+      return i < 0 ? 0 : size - 1;
+    default:
+    case EdgeType::Black:
+      return -1;
+  }
+}
+
+
 inline void vecTransposeFast(uint16_t* src,
                              uint16_t srcRows,
                              uint16_t srcCols,
@@ -258,6 +542,7 @@ inline void vecTransposeFast(uint16_t* src,
 
 }
 
+// Color of (indX, indY) in an interleaved RGB image, (px, py) is the pixel being filtered
 inline uint16_t getEdgeColor(
   EdgeType e,
   uint16_t* src,
@@ -268,37 +553,15 @@ inline uint16_t getEdgeColor(
   int32_t xSize,
   int32_t ySize,
   int32_t color) {
-  uint32_t xCoor = 0, yCoor = 0;
-  switch (e) {
-    case EdgeType::Wrap:// use overflow
-      if (indX < 0 || indX >= xSize) {
-        xCoor = xSize + (uint32_t)indX;
-      }
-      if (indY < 0 || indY >= ySize) {
-        yCoor = ySize + (uint32_t)indY;
-      }
-    case EdgeType::Reflect:
-      if (indX < 0) {
-        xCoor = -indX - 1;
-      } else if (indX >= xSize) {
-        xCoor = 2 * xSize - indX - 1;
-      }
-      if (indY < 0) {
-        yCoor = -indY - 1;
-      } else if (indY >= ySize) {
-        yCoor = 2 * ySize - indY - 1;
-      }
-      break;
-    case EdgeType::Copy:
-      xCoor = px;
-      yCoor = py;
-      break;
-    default: // default to black
-    case EdgeType::Black:
-      return 0xffff;
+  int32_t xCoor = px, yCoor = py;
+  if (e != EdgeType::Copy) {
+    xCoor = edgeIndex(e, indX, xSize);
+    yCoor = edgeIndex(e, indY, ySize);
+    if (xCoor < 0 || yCoor < 0)
+      return 0; // black
   }
 
-  return src[(xCoor * xSize + yCoor) * 3 + color];
+  return src[(xCoor + yCoor * xSize) * 3 + color];
 }
 
 inline uint16_t saturatingAdd(uint16_t a, uint16_t b) {
@@ -308,9 +571,76 @@ inline uint16_t saturatingAdd(uint16_t a, uint16_t b) {
   return temp;
 }
 
-// Convolve a 2D array with a 2D kernel (separated)
-// Note: Don't give this function more than 2^31-1 sized arrays
+// Q15 convolution kernel, odd number of taps (at most MaxKernelTaps)
+// Taps are signed; kernels whose taps sum well past 1.0 either way still saturate
+// correctly, they just take slower int64 accumulator loops
+const uint32_t MaxKernelTaps = 15;
+const uint32_t MaxKernelHalo = MaxKernelTaps / 2;
+const uint32_t MaxImageChannels = 4;
+
+struct Kernel15 {
+  const int16_t* taps;
+  uint32_t size;
+};
+
+// Ready made Q15 kernels, the 3/5 tap sizes take the unrolled fast paths
+const int16_t boxTaps3[] __attribute__((unused)) = { 10922, 10923, 10922 };
+const int16_t boxTaps5[] __attribute__((unused)) = { 6553, 6554, 6553, 6554, 6553 };
+const int16_t gaussTaps3[] __attribute__((unused)) = { 8192, 16384, 8192 };             // 1 2 1
+const int16_t gaussTaps5[] __attribute__((unused)) = { 2048, 8192, 12288, 8192, 2048 }; // 1 4 6 4 1
+
+const Kernel15 Box3 = { boxTaps3, 3 };
+const Kernel15 Box5 = { boxTaps5, 5 };
+const Kernel15 Gauss3 = { gaussTaps3, 3 };
+const Kernel15 Gauss5 = { gaussTaps5, 5 };
+
+// A 2D image made of numLines lines of lineLen pixels, each pixel `channels`
+// interleaved elements (uint16_t or uint8_t), and consecutive lines lineStride elements apart.
+// For the POV buffer a line is a column (the rings are contiguous, see indexAt).
+struct ImageLayout {
+  uint32_t lineLen;
+  uint32_t numLines;
+  uint32_t lineStride;
+  uint32_t channels;
+};
+
+// True two-pass separable convolution: across lines (src -> dst), then along each line
+// in place through a small halo-padded line buffer, so the inner loops never bounds check.
+// Q15 integer math throughout, results saturate to 0-0xffff (0-0xff for uint8_t, i.e.
+// Pixel8 data). src and dst must not overlap.
+// Kernels must have an odd number of taps, at most MaxKernelTaps, and an image at most
+// MaxImageChannels channels: otherwise src is copied to dst as is.
+// Edges are resolved per axis into halos up front, so wrapping costs nothing per tap.
+template <typename T>
+void convolveSeparable(const T* src,
+                       T* dst,
+                       const ImageLayout& layout,
+                       const Kernel15& kernelAlong,
+                       const Kernel15& kernelAcross,
+                       EdgePolicy edges);
+
+template <typename T>
+inline void convolveSeparable(const T* src,
+                              T* dst,
+                              const ImageLayout& layout,
+                              const Kernel15& kernelAlong,
+                              const Kernel15& kernelAcross,
+                              EdgeType edgeHandling) {
+  convolveSeparable(src, dst, layout, kernelAlong, kernelAcross, { edgeHandling, edgeHandling });
+}
+
+// Float tap to Q15, saturating: taps of 1.0 or more become 0x7fff instead of wrapping negative
+inline int16_t toQ15Tap(float tap) {
+  float q = tap * 32767.0f;
+  if (q >= 32767.0f)
+    return 32767;
+  if (q <= -32768.0f)
+    return -32768;
+  return (int16_t)q;
+}
 
+// Convolve a 2D array of interleaved RGB uint16_t with a 2D kernel (separated)
+// Float kernels are converted to Q15 once, see the overload above. Overwrites dst.
 inline void convolveSeparable(uint16_t* src,
                               uint32_t  srcSizeX,
                               uint32_t  srcSizeY,
@@ -320,90 +650,35 @@ inline void convolveSeparable(uint16_t* src,
                               uint32_t  kernelSizeY,
                               EdgeType  edgeHandling,
                               uint16_t* dst) { // assumes dst is the same dimensions as src
-
-
-  for (uint32_t py = 0; py < srcSizeY; py++) {
-    for (uint32_t px = 0; px < srcSizeX; px++) {
-      // for each pixel src[px][py]
-
-      int32_t kPixelOffset = 0;
-      int32_t baseIndex = (px + py * srcSizeX) * 3;
-      // Apply X-Kernel
-      for (uint32_t kx = 0; kx < kernelSizeX; kx++) {
-        kPixelOffset = kx - kernelSizeX / 2; // ranges from -kernelSizeX/2 <-> +kernelSizeX/2
-
-        // if out of bounds for x
-        if (px + kPixelOffset < 0 || px + kPixelOffset >= srcSizeX ) {
-          for (int c = 0; c < 3; c++) { // colors
-            dst[baseIndex + c] =
-              saturatingAdd(getEdgeColor(edgeHandling,
-                                         src,
-                                         baseIndex + (kPixelOffset * 3) + c,
-                                         py,
-                                         px,
-                                         py,
-                                         srcSizeX,
-                                         srcSizeY,
-                                         c),
-                            dst[baseIndex + c]);
-          }
-        } else {
-          for (int c = 0; c < 3; c++) { // colors
-            //printf("pixel (%d,%d)[%d]:%d, kernelX at %d, kernelOffset %d\n",px,py,baseIndex,c,kx,kPixelOffset);
-            //printf("adding src[%d] (=%d) * %f (=%f) + dst[%d] (=%d)\n",baseIndex + kPixelOffset * 3 + c,src[baseIndex + kPixelOffset * 3 + c],vecKernelX[kx], src[baseIndex + kPixelOffset * 3 + c] * vecKernelX[kx],baseIndex+c,dst[baseIndex+c]);
-            dst[baseIndex + c] =
-              saturatingAdd(src[baseIndex + (kPixelOffset * 3) + c] * vecKernelX[kx], dst[baseIndex + c]); // currPixel * kernel
-            //printf("new dst[] = %x\n\n",dst[baseIndex+c]);
-          }
-        }
-      }
-
-      // Since it's separable, no need to do nested kernel loop
-      // Apply Y-Kernel
-      for (uint32_t ky = 0; ky < kernelSizeY; ky++) {
-        // ranges from -kernelSizeX/2 <-> +kernelSizeX/2
-        kPixelOffset = (ky - kernelSizeY / 2);
-        // if out of bounds for y
-        if (py + kPixelOffset < 0 || py + kPixelOffset >= srcSizeY) {
-          for (int c = 0; c < 3; c++) {
-            dst[baseIndex + c] =
-              saturatingAdd(getEdgeColor(edgeHandling,
-                                         src,
-                                         px,
-                                         py,
-                                         px,
-                                         py,
-                                         srcSizeX,
-                                         srcSizeY,
-                                         c),
-                            dst[baseIndex + c]);
-          }
-
-        } else {
-          kPixelOffset *= srcSizeX;
-          for (int c = 0; c < 3; c++) {
-            dst[baseIndex + c] =
-              saturatingAdd(src[baseIndex + (kPixelOffset * 3) + c] * vecKernelY[ky], dst[baseIndex + c]);
-          }
-        }
-      }
-    }
-  }
+  // Oversized kernels keep their size so the Q15 overload passes the image through
+  int16_t tapsX[MaxKernelTaps], tapsY[MaxKernelTaps];
+  for (uint32_t k = 0; k < kernelSizeX && k < MaxKernelTaps; k++)
+    tapsX[k] = toQ15Tap(vecKernelX[k]);
+  for (uint32_t k = 0; k < kernelSizeY && k < MaxKernelTaps; k++)
+    tapsY[k] = toQ15Tap(vecKernelY[k]);
+
+  ImageLayout layout = { srcSizeX, srcSizeY, srcSizeX * 3, 3 };
+  convolveSeparable(src, dst, layout,
+                    { tapsX, kernelSizeX }, { tapsY, kernelSizeY },
+                    edgeHandling);
 }
 
-
-
-inline uint16_t* blur2d(uint16_t* myImg, int32_t imgWidth, int32_t imgHeight, uint16_t*myImgResult) {
-  float myKernelX[] = {1 / 3.0, 1 / 3.0, 1 / 3.0};
-  float myKernelY[] = {1 / 3.0, 1 / 3.0, 1 / 3.0};
-
-  convolveSeparable(myImg, imgWidth, imgHeight,
-                    myKernelX, 3, myKernelY, 3,
-                    EdgeType::Black, myImgResult);
+// For a POV buffer pass imgWidth = rings, imgHeight = columns and Cylindrical edges.
+// T is the channel type: (uint16_t*)pixels for a Pixel buffer, (uint8_t*)pixels for Pixel8
+template <typename T>
+inline T* blur2d(T* myImg, int32_t imgWidth, int32_t imgHeight, T* myImgResult,
+                 EdgePolicy edges) {
+  ImageLayout layout = { (uint32_t)imgWidth, (uint32_t)imgHeight, (uint32_t)imgWidth * 3, 3 };
+  convolveSeparable(myImg, myImgResult, layout, Box3, Box3, edges);
 
   return myImgResult;
 }
 
+template <typename T>
+inline T* blur2d(T* myImg, int32_t imgWidth, int32_t imgHeight, T* myImgResult) {
+  return blur2d(myImg, imgWidth, imgHeight, myImgResult, { EdgeType::Black, EdgeType::Black });
+}
+
 // ~4295s overflow on micros() -> 0.000232 Hz
 // micros overflows 
 inline uint16_t beat16(float hz, uint32_t offset) {
@@ -425,6 +700,206 @@ inline uint16_t beatSine16(float hz, uint32_t offset, uint16_t lo, uint16_t hi)
 
 //-------------------------//
 
+// Saturating uint16_t array kernels, 2 (DSP), 8 (SSE2/NEON) or 1 (scalar) lanes at a time
+// Pointers only need 2-byte alignment. src and dst may be the same array
+
+//-------------------------//
+
+// dst[i] = a[i] + b[i], saturating
+inline void vecQAdd16(const uint16_t* a, const uint16_t* b, uint16_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  for (; i + 2 <= numElems; i += 2) {
+    uint32_t wa, wb;
+    memcpy(&wa, a + i, 4);
+    memcpy(&wb, b + i, 4);
+    wa = __UQADD16(wa, wb);
+    memcpy(dst + i, &wa, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  for (; i + 8 <= numElems; i += 8) {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu16(va, vb));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  for (; i + 8 <= numElems; i += 8) {
+    vst1q_u16(dst + i, vqaddq_u16(vld1q_u16(a + i), vld1q_u16(b + i)));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qadd16(a[i], b[i]);
+  }
+}
+
+// dst[i] = src[i] + amt, saturating
+inline void vecQAdd16(const uint16_t* src, uint16_t amt, uint16_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  uint32_t packed = amt | ((uint32_t)amt << 16);
+  for (; i + 2 <= numElems; i += 2) {
+    uint32_t w;
+    memcpy(&w, src + i, 4);
+    w = __UQADD16(w, packed);
+    memcpy(dst + i, &w, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  __m128i vamt = _mm_set1_epi16((short)amt);
+  for (; i + 8 <= numElems; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu16(v, vamt));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  uint16x8_t vamt = vdupq_n_u16(amt);
+  for (; i + 8 <= numElems; i += 8) {
+    vst1q_u16(dst + i, vqaddq_u16(vld1q_u16(src + i), vamt));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qadd16(src[i], amt);
+  }
+}
+
+// dst[i] = src[i] - amt, saturating at 0
+inline void vecQSub16(const uint16_t* src, uint16_t amt, uint16_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  uint32_t packed = amt | ((uint32_t)amt << 16);
+  for (; i + 2 <= numElems; i += 2) {
+    uint32_t w;
+    memcpy(&w, src + i, 4);
+    w = __UQSUB16(w, packed);
+    memcpy(dst + i, &w, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  __m128i vamt = _mm_set1_epi16((short)amt);
+  for (; i + 8 <= numElems; i += 8) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_subs_epu16(v, vamt));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  uint16x8_t vamt = vdupq_n_u16(amt);
+  for (; i + 8 <= numElems; i += 8) {
+    vst1q_u16(dst + i, vqsubq_u16(vld1q_u16(src + i), vamt));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qsub16(src[i], amt);
+  }
+}
+
+// Same for uint8_t, 4 (DSP) or 16 (SSE2/NEON) lanes at a time
+inline void vecQAdd8(const uint8_t* a, const uint8_t* b, uint8_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  for (; i + 4 <= numElems; i += 4) {
+    uint32_t wa, wb;
+    memcpy(&wa, a + i, 4);
+    memcpy(&wb, b + i, 4);
+    wa = __UQADD8(wa, wb);
+    memcpy(dst + i, &wa, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  for (; i + 16 <= numElems; i += 16) {
+    __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+    __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(va, vb));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  for (; i + 16 <= numElems; i += 16) {
+    vst1q_u8(dst + i, vqaddq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qadd8(a[i], b[i]);
+  }
+}
+
+inline void vecQAdd8(const uint8_t* src, uint8_t amt, uint8_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  uint32_t packed = amt * 0x01010101u;
+  for (; i + 4 <= numElems; i += 4) {
+    uint32_t w;
+    memcpy(&w, src + i, 4);
+    w = __UQADD8(w, packed);
+    memcpy(dst + i, &w, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  __m128i vamt = _mm_set1_epi8((char)amt);
+  for (; i + 16 <= numElems; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epu8(v, vamt));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  uint8x16_t vamt = vdupq_n_u8(amt);
+  for (; i + 16 <= numElems; i += 16) {
+    vst1q_u8(dst + i, vqaddq_u8(vld1q_u8(src + i), vamt));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qadd8(src[i], amt);
+  }
+}
+
+inline void vecQSub8(const uint8_t* src, uint8_t amt, uint8_t* dst, uint32_t numElems) {
+  uint32_t i = 0;
+#if defined(TGRAPHICS_SIMD_DSP)
+  uint32_t packed = amt * 0x01010101u;
+  for (; i + 4 <= numElems; i += 4) {
+    uint32_t w;
+    memcpy(&w, src + i, 4);
+    w = __UQSUB8(w, packed);
+    memcpy(dst + i, &w, 4);
+  }
+#elif defined(TGRAPHICS_SIMD_SSE2)
+  __m128i vamt = _mm_set1_epi8((char)amt);
+  for (; i + 16 <= numElems; i += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+    _mm_storeu_si128((__m128i*)(dst + i), _mm_subs_epu8(v, vamt));
+  }
+#elif defined(TGRAPHICS_SIMD_NEON)
+  uint8x16_t vamt = vdupq_n_u8(amt);
+  for (; i + 16 <= numElems; i += 16) {
+    vst1q_u8(dst + i, vqsubq_u8(vld1q_u8(src + i), vamt));
+  }
+#endif
+  for (; i < numElems; i++) {
+    dst[i] = qsub8(src[i], amt);
+  }
+}
+
+// Channel depth dispatch for the PixelT kernels below
+inline void vecQAdd(const uint16_t* a, const uint16_t* b, uint16_t* dst, uint32_t numElems) {
+  vecQAdd16(a, b, dst, numElems);
+}
+
+inline void vecQAdd(const uint8_t* a, const uint8_t* b, uint8_t* dst, uint32_t numElems) {
+  vecQAdd8(a, b, dst, numElems);
+}
+
+inline void vecQAdd(const uint16_t* src, uint16_t amt, uint16_t* dst, uint32_t numElems) {
+  vecQAdd16(src, amt, dst, numElems);
+}
+
+inline void vecQAdd(const uint8_t* src, uint8_t amt, uint8_t* dst, uint32_t numElems) {
+  vecQAdd8(src, amt, dst, numElems);
+}
+
+inline void vecQSub(const uint16_t* src, uint16_t amt, uint16_t* dst, uint32_t numElems) {
+  vecQSub16(src, amt, dst, numElems);
+}
+
+inline void vecQSub(const uint8_t* src, uint8_t amt, uint8_t* dst, uint32_t numElems) {
+  vecQSub8(src, amt, dst, numElems);
+}
+
+// A PixelT is three packed channels, so PixelT arrays go through the same kernels
+static_assert(sizeof(Pixel) == 3 * sizeof(uint16_t), "Pixel must be 3 packed uint16_t channels");
+static_assert(sizeof(Pixel8) == 3 * sizeof(uint8_t), "Pixel8 must be 3 packed uint8_t channels");
+
+//-------------------------//
+
 // Default 'slow'/non-saturating version
 
 //-------------------------//
@@ -441,71 +916,145 @@ inline void vecFill(uint16_t* src, uint16_t* dst, uint32_t numElems, uint16_t mo
   }
 }
 
-inline void vecFill(const Pixel* src, Pixel* dst, uint32_t numElems) {
-  for (uint32_t i = 0; i < numElems; i++) {
-    dst[i] = src[i];
-  }
+// Plain copy, the per-Pixel loop doesn't get turned into wide moves
+template <typename T, ChannelOrder O>
+inline void vecFill(const PixelT<T, O>* src, PixelT<T, O>* dst, uint32_t numElems) {
+  memmove(dst, src, numElems * sizeof(PixelT<T, O>));
 }
 
-inline void vecFill(const Pixel* src, Pixel* dst, uint32_t numElems, uint16_t mod) {
+template <typename T, ChannelOrder O>
+inline void vecFill(const PixelT<T, O>* src, PixelT<T, O>* dst, uint32_t numElems, uint16_t mod) {
   for (uint32_t i = 0; i < numElems; i++) {
     dst[i] = src[i % mod];
   }
 }
 
-inline void vecFill(const Pixel src, Pixel* dst, uint32_t numElems) {
+template <typename T, ChannelOrder O>
+inline void vecFill(const typename NoDeduce<PixelT<T, O>>::type src, PixelT<T, O>* dst, uint32_t numElems) {
   for (uint32_t i = 0; i < numElems; i++) {
     dst[i] = src;
   }
 }
 
+// dst += src, saturating
 inline void vecAdd(uint16_t* src, uint16_t* dst, uint32_t numElems) {
-  for (uint32_t i = 0; i < numElems; i++) {
-    dst[i] += src[i];
-  }
+  vecQAdd16(dst, src, dst, numElems);
+}
+
+template <typename T, ChannelOrder O>
+inline void vecAdd(PixelT<T, O>* src, PixelT<T, O>* dst, uint32_t numElems) {
+  TGRAPHICS_PROBE("vecAdd");
+  vecQAdd((T*)dst, (T*)src, (T*)dst, numElems * 3);
 }
 
 inline void vecFade(uint16_t* src, uint16_t* dst, uint16_t fadeAmt, uint32_t numElems) {
+  vecQSub16(src, fadeAmt, dst, numElems);
+}
+
+// fadeAmt is in channel units, so the same fade is 1/256th as much on a Pixel as on a Pixel8
+template <typename T, ChannelOrder O>
+inline void vecFade(PixelT<T, O>* src, PixelT<T, O>* dst, typename NoDeduce<T>::type fadeAmt, uint32_t numElems) {
+  TGRAPHICS_PROBE("vecFade");
+  vecQSub((T*)src, fadeAmt, (T*)dst, numElems * 3);
+}
+
+inline void vecBrighten(uint16_t* src, uint16_t* dst, uint16_t fadeAmt, uint32_t numElems) {
+  vecQAdd16(src, fadeAmt, dst, numElems);
+}
+
+template <typename T, ChannelOrder O>
+inline void vecBrighten(PixelT<T, O>* src, PixelT<T, O>* dst, typename NoDeduce<T>::type fadeAmt, uint32_t numElems) {
+  TGRAPHICS_PROBE("vecBrighten");
+  vecQAdd((T*)src, fadeAmt, (T*)dst, numElems * 3);
+}
+
+inline void vecScale(const uint16_t* src, uint16_t* dst, Scale16 scale, uint32_t numElems) {
   for (uint32_t i = 0; i < numElems; i++) {
-    dst[i] = qsub16(src[i], fadeAmt);
+    dst[i] = qmult16(src[i], scale);
   }
 }
 
-inline void vecFade(Pixel* src, Pixel* dst, uint16_t fadeAmt, uint32_t numElems) {
+template <typename T, ChannelOrder O>
+inline void vecScale(const PixelT<T, O>* src, PixelT<T, O>* dst, Scale16 scale, uint32_t numElems) {
+  TGRAPHICS_PROBE("vecScale");
   for (uint32_t i = 0; i < numElems; i++) {
-    dst[i] = src[i] - fadeAmt;
+    dst[i] = src[i] * scale;
   }
 }
 
-inline void vecBrighten(uint16_t* src, uint16_t* dst, uint16_t fadeAmt, uint32_t numElems) {
+// dst = a * frac + b * (1 - frac), frac in Q0.16 (same as lerp_uint)
+template <typename T, ChannelOrder O>
+inline void vecLerp(const PixelT<T, O>* a, const PixelT<T, O>* b, PixelT<T, O>* dst, uint16_t frac,
+                    uint32_t numElems) {
+  TGRAPHICS_PROBE("vecLerp");
+  uint32_t weight = fracWeight16(frac);
   for (uint32_t i = 0; i < numElems; i++) {
-    dst[i] = qadd16(src[i], fadeAmt);
+    dst[i].blue = lerp16(a[i].blue, b[i].blue, weight);
+    dst[i].green = lerp16(a[i].green, b[i].green, weight);
+    dst[i].red = lerp16(a[i].red, b[i].red, weight);
   }
 }
 
-// Average with 4% loss on purpose
-inline Pixel avg(const Pixel& one, const Pixel& two) {
-    return one * 0.48f + two * 0.48f;
+// Average with 4% loss on purpose (123/256 ~= 0.48)
+template <typename T, ChannelOrder O>
+inline PixelT<T, O> avg(const PixelT<T, O>& one, const PixelT<T, O>& two) {
+    return { (T)((((uint32_t)one.blue + two.blue) * 123) >> 8),
+             (T)((((uint32_t)one.green + two.green) * 123) >> 8),
+             (T)((((uint32_t)one.red + two.red) * 123) >> 8) };
 }
 
+// Q0.16 blur weights, computed once per blur instead of once per pixel
+struct BlurWeights {
+    uint32_t sides;
+    uint32_t center;
+};
 
 // blur amt go from totally even avg (1.0) to only center pixel color (0.0)
-inline Pixel avg(const Pixel& l, const Pixel& mid, const Pixel& r, float blurAmt) {
+inline BlurWeights blurWeights(float blurAmt) {
     float sides = (blurAmt - 0.05) / 3.;
-    float center = 1.0 - sides * 2;
-    return l * sides + mid * center + r * sides;
+    if (sides < 0.0f) sides = 0.0f; // below 0.05 it's just the center pixel
+    uint32_t sidesQ = (uint32_t)(sides * 65536.0f);
+    return { sidesQ, 0x10000 - sidesQ * 2 };
+}
+
+inline uint16_t avg16(uint16_t l, uint16_t mid, uint16_t r, const BlurWeights& w) {
+    return ((uint32_t)l * w.sides + (uint32_t)mid * w.center + (uint32_t)r * w.sides) >> 16;
+}
+
+template <typename T, ChannelOrder O>
+inline PixelT<T, O> avg(const PixelT<T, O>& l, const PixelT<T, O>& mid, const PixelT<T, O>& r, const BlurWeights& w) {
+    return { (T)avg16(l.blue, mid.blue, r.blue, w),
+             (T)avg16(l.green, mid.green, r.green, w),
+             (T)avg16(l.red, mid.red, r.red, w) };
+}
+
+template <typename T, ChannelOrder O>
+inline PixelT<T, O> avg(const PixelT<T, O>& l, const PixelT<T, O>& mid, const PixelT<T, O>& r, float blurAmt) {
+    return avg(l, mid, r, blurWeights(blurAmt));
 }
 
-inline void vecBlur(Pixel* src, Pixel* dst, float blurAmt, uint32_t numElems) {
+template <typename T, ChannelOrder O>
+inline void vecBlur(PixelT<T, O>* src, PixelT<T, O>* dst, float blurAmt, uint32_t numElems) {
+    TGRAPHICS_PROBE("vecBlur");
     blurAmt = blurAmt > 1.0 ? 1.0 : blurAmt;
     blurAmt = blurAmt < 0.0 ? 0.0 : blurAmt;
+    BlurWeights w = blurWeights(blurAmt);
 
-    for (uint32_t i = 0; i < numElems; i++) {
-        dst[i] = avg(src[(i+1) % numElems],
-                     src[i],
-                     src[(numElems + (i-1)) % numElems],
-                     blurAmt);
+    if (numElems < 2) {
+        if (numElems == 1)
+            dst[0] = avg(src[0], src[0], src[0], w);
+        return;
+    }
+
+    // wrap around: first and last blend together, no modulo in the loop
+    PixelT<T, O> first = src[0];
+    PixelT<T, O> prev = src[numElems - 1];
+    for (uint32_t i = 0; i < numElems - 1; i++) {
+        PixelT<T, O> mid = src[i];
+        dst[i] = avg(src[i + 1], mid, prev, w);
+        prev = mid;
     }
+    dst[numElems - 1] = avg(first, src[numElems - 1], prev, w);
 }
 
 // interpolates across a table
@@ -518,6 +1067,8 @@ inline Pixel rainbowAt(float percent, const Pixel* rainbowTable, uint32_t tableS
   return lerp_float(rainbowTable[index],rainbowTable[(index + 1) % tableSize],fracPart);
 }
 
+// Hex text, one Serial.print at a time: fine for a pixel or two, far too slow for whole
+// frames (use FrameDump in frame_dump.h)
 inline void printPixel(const Pixel& p) {
     Serial.print("0x");
     Serial.print(p.red,HEX);
@@ -548,27 +1099,27 @@ inline void printGsBuffer(uint16_t *buff, uint32_t numElems) {
 }
 
 namespace Colors {
-    const RGB_Color Black =       { 0x0000, 0x0000, 0x0000 };
-    const RGB_Color White =       { 0x00ff, 0x00ff, 0x00ff };
+    constexpr RGB_Color Black =       { 0x0000, 0x0000, 0x0000 };
+    constexpr RGB_Color White =       { 0x00ff, 0x00ff, 0x00ff };
     // 12 color Rainbow!
-    const RGB_Color Red =         { 0x00ff, 0x0000, 0x0000 };
-    const RGB_Color Orange =      { 0x00ff, 0x007f, 0x0000 };
-    const RGB_Color Yellow =      { 0x00ff, 0x00ff, 0x0000 };
-    const RGB_Color Chartreuse =  { 0x007f, 0x00ff, 0x0000 };
-    const RGB_Color Green =       { 0x0000, 0x00ff, 0x0000 };
-    const RGB_Color SpringGreen = { 0x0000, 0x00ff, 0x007f };
-    const RGB_Color Cyan =        { 0x0000, 0x00ff, 0x00ff };
-    const RGB_Color DodgerBlue =  { 0x0000, 0x007f, 0x00ff };
-    const RGB_Color Blue =        { 0x0000, 0x0000, 0x00ff };
-    const RGB_Color Purple =      { 0x007f, 0x0000, 0x00ff };
-    const RGB_Color Violet =      { 0x00ff, 0x0000, 0x00ff };
-    const RGB_Color Magenta =     { 0x00ff, 0x0000, 0x0080 };
-    const RGB_Color Indigo =      { 0x002b, 0x0006, 0x007f };
-    const RGB_Color SoftRed =     { 0x0001, 0x0000, 0x0000 };
-    const RGB_Color RoyalPurple = { 0x008a, 0x0006, 0x00cf };
+    constexpr RGB_Color Red =         { 0x00ff, 0x0000, 0x0000 };
+    constexpr RGB_Color Orange =      { 0x00ff, 0x007f, 0x0000 };
+    constexpr RGB_Color Yellow =      { 0x00ff, 0x00ff, 0x0000 };
+    constexpr RGB_Color Chartreuse =  { 0x007f, 0x00ff, 0x0000 };
+    constexpr RGB_Color Green =       { 0x0000, 0x00ff, 0x0000 };
+    constexpr RGB_Color SpringGreen = { 0x0000, 0x00ff, 0x007f };
+    constexpr RGB_Color Cyan =        { 0x0000, 0x00ff, 0x00ff };
+    constexpr RGB_Color DodgerBlue =  { 0x0000, 0x007f, 0x00ff };
+    constexpr RGB_Color Blue =        { 0x0000, 0x0000, 0x00ff };
+    constexpr RGB_Color Purple =      { 0x007f, 0x0000, 0x00ff };
+    constexpr RGB_Color Violet =      { 0x00ff, 0x0000, 0x00ff };
+    constexpr RGB_Color Magenta =     { 0x00ff, 0x0000, 0x0080 };
+    constexpr RGB_Color Indigo =      { 0x002b, 0x0006, 0x007f };
+    constexpr RGB_Color SoftRed =     { 0x0001, 0x0000, 0x0000 };
+    constexpr RGB_Color RoyalPurple = { 0x008a, 0x0006, 0x00cf };
 };
 
-const Pixel colorPalette[]  __attribute__((unused)) = {
+constexpr Pixel colorPalette[]  __attribute__((unused)) = {
   Colors::Black,
   Colors::White, // white
   Colors::Red, // red
@@ -585,7 +1136,7 @@ const Pixel colorPalette[]  __attribute__((unused)) = {
   Colors::Magenta, // magenta
 };
 
-const Pixel colorsExceptBlack[]  __attribute__((unused)) = {
+constexpr Pixel colorsExceptBlack[]  __attribute__((unused)) = {
   Colors::White, // white
   Colors::Red, // red
   Colors::Orange, // orange
@@ -602,13 +1153,13 @@ const Pixel colorsExceptBlack[]  __attribute__((unused)) = {
   Colors::RoyalPurple,
 };
 
-const Pixel rgbPalette[] __attribute__((unused)) = {
+constexpr Pixel rgbPalette[] __attribute__((unused)) = {
     Colors::Red,
     Colors::Green,
     Colors::Blue
 };
 
-const Pixel rainbow7[] __attribute__((unused)) = {
+constexpr Pixel rainbow7[] __attribute__((unused)) = {
   Colors::Red,
   Colors::Orange,
   Colors::Yellow,
@@ -618,7 +1169,7 @@ const Pixel rainbow7[] __attribute__((unused)) = {
   Colors::Violet,
 };
 
-const Pixel rainbow12[] __attribute__((unused)) = {
+constexpr Pixel rainbow12[] __attribute__((unused)) = {
   Colors::Red,
   Colors::Orange,
   Colors::Yellow,
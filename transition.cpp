@@ -0,0 +1,137 @@
+#include "transition.h"
+
+Transition::Transition(PixelArena& scratch) : arena(scratch) {
+  arenaMark = 0;
+  outgoing = nullptr;
+  incoming = nullptr;
+  bufOut = nullptr;
+  bufIn = nullptr;
+  startUs = 0;
+  duration = 0;
+  softness = 0;
+  prog = 0;
+  kind = TransitionType::Cut;
+  active = false;
+  r = 0;
+  d = 0;
+  pixels = nullptr;
+}
+
+void Transition::start(Demo& from, Demo& to, Pixel* display, uint32_t rings, uint32_t cols,
+                       TransitionType type, uint32_t durationUs) {
+  if (active)
+    finish(); // jump to the end of the one already running
+  r = rings;
+  d = cols;
+  pixels = display;
+  outgoing = &from;
+  incoming = &to;
+  kind = type;
+  duration = durationUs;
+  prog = 0;
+
+  uint32_t n = rings * cols;
+  arenaMark = arena.mark();
+  bufOut = type == TransitionType::Cut || durationUs == 0 ? nullptr : arena.alloc(n);
+  bufIn = bufOut ? arena.alloc(n) : nullptr;
+  if (!bufIn) { // no room (or nothing to blend), just cut
+    arena.release(arenaMark);
+    incoming->setup(pixels, r, d);
+    active = false;
+    return;
+  }
+  // the outgoing demo keeps its current frame, but in scratch
+  vecFill(pixels, bufOut, n);
+  outgoing->setBuffer(bufOut);
+  incoming->setup(bufIn, r, d);
+  startUs = micros();
+  active = true;
+}
+
+void Transition::tick() {
+  TGRAPHICS_PROBE("Transition::tick");
+  if (!active) {
+    if (incoming)
+      incoming->tick();
+    return;
+  }
+  outgoing->tick();
+  incoming->tick();
+  uint32_t elapsed = micros() - startUs;
+  if (elapsed >= duration) {
+    finish();
+    return;
+  }
+  prog = (uint16_t)(((uint64_t)elapsed << 16) / duration);
+  blend();
+}
+
+void Transition::processKeypress(uint16_t keys, uint16_t diff) {
+  if (incoming)
+    incoming->processKeypress(keys, diff);
+}
+
+// Rotations are baked in while blending, afterwards it's the incoming demo's
+uint32_t Transition::rotation() const {
+  if (active || !incoming)
+    return 0;
+  return incoming->rotation();
+}
+
+void Transition::finish() {
+  vecFill(bufIn, pixels, r * d);
+  incoming->setBuffer(pixels);
+  arena.release(arenaMark);
+  prog = 0xffff;
+  active = false;
+}
+
+// One column of the crossfade
+void Transition::blendFade(uint32_t col, const Pixel* a, const Pixel* b) {
+  vecLerp(b, a, pixels + indexAt(r, col, 0), prog, r);
+}
+
+// Rings inside the band blend, inside it is all incoming, outside all outgoing
+void Transition::blendIris(uint32_t col, const Pixel* a, const Pixel* b, uint32_t band) {
+  Pixel* dst = pixels + indexAt(r, col, 0);
+  // edge of the band, runs from -band to r over the transition
+  int32_t edge = (int32_t)(((uint64_t)(r + band) * prog) >> 16) - (int32_t)band;
+  uint32_t inner = edge < 0 ? 0 : (uint32_t)edge;
+  uint32_t outer = edge + (int32_t)band > (int32_t)r ? r : (uint32_t)(edge + (int32_t)band);
+  vecFill(b, dst, inner);
+  for (uint32_t j = inner; j < outer; j++) {
+    uint32_t w = (uint32_t)(((int32_t)j - edge) * 0xffff / (int32_t)band); // 0 at the inner edge
+    dst[j] = lerp_uint(a[j], b[j], (uint16_t)w);
+  }
+  vecFill(a + outer, dst + outer, r - outer);
+}
+
+void Transition::blend() {
+  uint32_t rotOut = (outgoing->rotation() >> 16) % d;
+  uint32_t rotIn = (incoming->rotation() >> 16) % d;
+  uint32_t band = softness ? softness : (kind == TransitionType::Wipe ? d / 8 : r / 4);
+  band = band ? band : 1;
+  // Wipe: the band's leading column runs from 0 to d + band
+  int32_t edge = (int32_t)(((uint64_t)(d + band) * prog) >> 16);
+  uint32_t srcOut = rotOut, srcIn = rotIn;
+  for (uint32_t col = 0; col < d; col++) {
+    const Pixel* a = bufOut + indexAt(r, srcOut, 0);
+    const Pixel* b = bufIn + indexAt(r, srcIn, 0);
+    Pixel* dst = pixels + indexAt(r, col, 0);
+    if (kind == TransitionType::Fade) {
+      blendFade(col, a, b);
+    } else if (kind == TransitionType::Iris) {
+      blendIris(col, a, b, band);
+    } else {
+      int32_t behind = edge - (int32_t)col; // how far the edge has passed this column
+      if (behind <= 0)
+        vecFill(a, dst, r);
+      else if (behind >= (int32_t)band)
+        vecFill(b, dst, r);
+      else
+        vecLerp(b, a, dst, (uint16_t)(behind * 0xffff / band), r);
+    }
+    srcOut = srcOut + 1 == d ? 0 : srcOut + 1;
+    srcIn = srcIn + 1 == d ? 0 : srcIn + 1;
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef __TRANSITION_H
+#define __TRANSITION_H
+#include "tgraphics.h"
+#include "animation_demos.h"
+#include "arena.h"
+#include <cstdint>
+
+// Smooth switch between two running demos
+// While a transition runs, both demos keep ticking, each into its own scratch buffer
+// from a PixelArena, and the display buffer is built from the two with integer lerps.
+// Only the band that is actually mid-transition is blended; everything that has
+// already switched (or hasn't started to) is a straight copy. When it's done the
+// incoming demo is moved onto the display buffer and the scratch buffers go back.
+// A Transition is itself a Demo, so the show loop can just tick it:
+//
+//   StaticPixelArena<2 * 32 * 256> scratch;
+//   Transition fader(scratch);
+//   ...on keypress:
+//   fader.start(*current, *next, pixels, 32, 256, TransitionType::Wipe, 500000);
+//   current = &fader;
+//   ...every frame:
+//   current->tick();
+//   if (fader.done()) current = next;
+
+enum class TransitionType : uint8_t {
+  Cut,  // switch straight away
+  Fade, // whole frame crossfade
+  Wipe, // incoming sweeps in column by column
+  Iris, // incoming grows out from the center ring
+};
+
+class Transition : public Demo {
+  public:
+    Transition(PixelArena& scratch);
+
+    // Falls back to a cut if the arena can't hold two frames
+    void start(Demo& from, Demo& to, Pixel* display, uint32_t rings, uint32_t cols,
+               TransitionType type, uint32_t durationUs);
+    // Width of the blended band for Wipe (columns) and Iris (rings), 0 for the default
+    void setSoftness(uint32_t cells) { softness = cells; }
+
+    bool done() const { return !active; }
+    uint16_t progress() const { return prog; } // Q0.16
+
+    void tick();
+    // Keys go to the incoming demo
+    void processKeypress(uint16_t keys, uint16_t diff);
+    uint32_t rotation() const;
+
+  private:
+    void blend();
+    void blendFade(uint32_t col, const Pixel* a, const Pixel* b);
+    void blendIris(uint32_t col, const Pixel* a, const Pixel* b, uint32_t band);
+    void finish();
+
+    PixelArena& arena;
+    uint32_t arenaMark;
+    Demo* outgoing;
+    Demo* incoming;
+    Pixel* bufOut;
+    Pixel* bufIn;
+    uint32_t startUs;
+    uint32_t duration;
+    uint32_t softness;
+    uint16_t prog;
+    TransitionType kind;
+    bool active;
+};
+
+#endif // ifndef __TRANSITION_H